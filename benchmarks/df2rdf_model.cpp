@@ -0,0 +1,79 @@
+// Conversion-only model of df2rdf, old (baseline) vs new (single pass).
+// AMPL cells are modelled as tagged variants; R vectors as malloc'ed
+// buffers. The AMPL transfer and R's own allocator are not included.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+enum Type { EMPTY, NUMERIC, STRING };
+struct Variant { Type type; double dbl; const char *str; };
+
+static std::size_t current = 0, peak = 0;
+static void *track(std::size_t n) { current += n; if(current > peak) peak = current; return std::malloc(n); }
+static void untrack(void *p, std::size_t n) { current -= n; std::free(p); }
+
+template <class T> struct Counting {
+  typedef T value_type;
+  Counting() {}
+  template <class U> Counting(const Counting<U> &) {}
+  T *allocate(std::size_t n) { return static_cast<T *>(track(n * sizeof(T))); }
+  void deallocate(T *p, std::size_t n) { untrack(p, n * sizeof(T)); }
+};
+template <class T, class U> bool operator==(const Counting<T> &, const Counting<U> &) { return true; }
+template <class T, class U> bool operator!=(const Counting<T> &, const Counting<U> &) { return false; }
+
+// Baseline: type check pass, push_back into an unreserved vector, copy
+// into the R vector (Rcpp::wrap), copy again (Rcpp::DataFrame(list)).
+static double *oldColumn(const std::vector<Variant> &col) {
+  bool numeric = true;
+  for(std::size_t i = 0; i < col.size(); i++) {
+    if(col[i].type != NUMERIC) { numeric = false; break; }
+  }
+  if(!numeric) return NULL;
+  std::vector<double, Counting<double> > tmp;
+  for(std::size_t i = 0; i < col.size(); i++) tmp.push_back(col[i].dbl);
+  std::size_t bytes = col.size() * sizeof(double);
+  double *wrapped = static_cast<double *>(track(bytes));
+  std::memcpy(wrapped, tmp.data(), bytes);
+  double *frame = static_cast<double *>(track(bytes));
+  std::memcpy(frame, wrapped, bytes);
+  untrack(wrapped, bytes);
+  return frame;
+}
+
+// New: one allocation at the final size, filled in one typed pass.
+static double *newColumn(const std::vector<Variant> &col) {
+  std::size_t bytes = col.size() * sizeof(double);
+  double *out = static_cast<double *>(track(bytes));
+  for(std::size_t i = 0; i < col.size(); i++) {
+    if(col[i].type != NUMERIC) { untrack(out, bytes); return NULL; }
+    out[i] = col[i].dbl;
+  }
+  return out;
+}
+
+template <class F> static void run(const char *label, const std::vector<std::vector<Variant> > &cols, F convert) {
+  current = peak = 0;
+  std::vector<double *> out;
+  auto start = std::chrono::steady_clock::now();
+  for(std::size_t c = 0; c < cols.size(); c++) out.push_back(convert(cols[c]));
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::printf("%-4s time=%7.3fs peak=%8.1fMb\n", label, elapsed, peak / 1048576.0);
+  for(std::size_t c = 0; c < out.size(); c++) untrack(out[c], cols[c].size() * sizeof(double));
+}
+
+int main(int argc, char **argv) {
+  std::size_t n = argc > 1 ? std::atof(argv[1]) : 1e7;
+  std::vector<std::vector<Variant> > cols(3, std::vector<Variant>(n));
+  for(std::size_t i = 0; i < n; i++) {
+    Variant a = {NUMERIC, double(i / 10 + 1), NULL}, b = {NUMERIC, double(i % 10 + 1), NULL}, v = {NUMERIC, 1.5, NULL};
+    cols[0][i] = a; cols[1][i] = b; cols[2][i] = v;
+  }
+  for(int rep = 0; rep < 3; rep++) {
+    run("old", cols, oldColumn);
+    run("new", cols, newColumn);
+  }
+  return 0;
+}
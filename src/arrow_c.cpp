@@ -0,0 +1,408 @@
+#include "arrow_c.h"
+#include "utils.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <Rcpp.h>
+
+namespace {
+
+// ---- Export: ampl::DataFrame -> ArrowArrayStream ----
+
+struct SchemaData {
+  std::string format;
+  std::string name;
+  std::vector<struct ArrowSchema *> children;
+};
+
+void releaseSchema(struct ArrowSchema *schema) {
+  SchemaData *data = static_cast<SchemaData *>(schema->private_data);
+  for(std::size_t i = 0; i < data->children.size(); i++) {
+    if(data->children[i]->release != NULL) {
+      data->children[i]->release(data->children[i]);
+    }
+    delete data->children[i];
+  }
+  delete data;
+  schema->release = NULL;
+}
+
+void initSchema(struct ArrowSchema *schema, const std::string &format, const std::string &name,
+                int64_t flags, std::size_t nchildren) {
+  SchemaData *data = new SchemaData();
+  data->format = format;
+  data->name = name;
+  for(std::size_t i = 0; i < nchildren; i++) {
+    data->children.push_back(new ArrowSchema());
+  }
+  schema->format = data->format.c_str();
+  schema->name = data->name.c_str();
+  schema->metadata = NULL;
+  schema->flags = flags;
+  schema->n_children = nchildren;
+  schema->children = nchildren > 0 ? data->children.data() : NULL;
+  schema->dictionary = NULL;
+  schema->release = releaseSchema;
+  schema->private_data = data;
+}
+
+struct ArrayData {
+  std::vector<uint8_t> validity;
+  std::vector<double> values;
+  std::vector<int64_t> offsets;
+  std::string chars;
+  std::vector<const void *> buffers;
+  std::vector<struct ArrowArray *> children;
+};
+
+void releaseArray(struct ArrowArray *array) {
+  ArrayData *data = static_cast<ArrayData *>(array->private_data);
+  for(std::size_t i = 0; i < data->children.size(); i++) {
+    if(data->children[i]->release != NULL) {
+      data->children[i]->release(data->children[i]);
+    }
+    delete data->children[i];
+  }
+  delete data;
+  array->release = NULL;
+}
+
+// Copies an AMPL column into an Arrow array and returns its format:
+// float64 if all values are numeric, large_utf8 otherwise.
+std::string exportColumn(const ampl::DataFrame::Column &col, std::size_t nrows, struct ArrowArray *array) {
+  bool numeric = true;
+  int64_t nulls = 0;
+  for(std::size_t i = 0; i < nrows; i++) {
+    ampl::VariantRef value = col[i];
+    if(value.type() == ampl::STRING) {
+      numeric = false;
+    } else if(value.type() != ampl::NUMERIC) {
+      nulls++;
+    }
+  }
+  ArrayData *data = new ArrayData();
+  if(nulls > 0) {
+    data->validity.assign((nrows + 7) / 8, 0);
+  }
+  if(numeric) {
+    data->values.resize(nrows);
+  } else {
+    data->offsets.resize(nrows + 1);
+    data->offsets[0] = 0;
+  }
+  for(std::size_t i = 0; i < nrows; i++) {
+    ampl::VariantRef value = col[i];
+    bool valid = value.type() == ampl::NUMERIC || value.type() == ampl::STRING;
+    if(valid && nulls > 0) {
+      data->validity[i / 8] |= static_cast<uint8_t>(1 << (i % 8));
+    }
+    if(numeric) {
+      data->values[i] = valid ? value.dbl() : 0;
+    } else {
+      if(value.type() == ampl::STRING) {
+        data->chars.append(value.c_str());
+      } else if(value.type() == ampl::NUMERIC) {
+        data->chars.append(dbl2str(value.dbl()));
+      }
+      data->offsets[i + 1] = data->chars.size();
+    }
+  }
+  data->buffers.push_back(nulls > 0 ? data->validity.data() : NULL);
+  if(numeric) {
+    data->buffers.push_back(data->values.data());
+  } else {
+    data->buffers.push_back(data->offsets.data());
+    data->buffers.push_back(data->chars.data());
+  }
+  array->length = nrows;
+  array->null_count = nulls;
+  array->offset = 0;
+  array->n_buffers = data->buffers.size();
+  array->n_children = 0;
+  array->buffers = data->buffers.data();
+  array->children = NULL;
+  array->dictionary = NULL;
+  array->release = releaseArray;
+  array->private_data = data;
+  return numeric ? "g" : "U";
+}
+
+struct StreamData {
+  std::vector<std::string> names;
+  std::vector<std::string> formats;
+  struct ArrowArray batch;
+};
+
+int streamGetSchema(struct ArrowArrayStream *stream, struct ArrowSchema *out) {
+  StreamData *data = static_cast<StreamData *>(stream->private_data);
+  initSchema(out, "+s", "", 0, data->names.size());
+  for(std::size_t i = 0; i < data->names.size(); i++) {
+    initSchema(out->children[i], data->formats[i], data->names[i], ARROW_FLAG_NULLABLE, 0);
+  }
+  return 0;
+}
+
+// The whole table is sent as a single record batch; the following call
+// returns a released array, which marks the end of the stream.
+int streamGetNext(struct ArrowArrayStream *stream, struct ArrowArray *out) {
+  StreamData *data = static_cast<StreamData *>(stream->private_data);
+  *out = data->batch;
+  data->batch.release = NULL;
+  return 0;
+}
+
+const char *streamGetLastError(struct ArrowArrayStream *stream) {
+  return NULL;
+}
+
+void streamRelease(struct ArrowArrayStream *stream) {
+  StreamData *data = static_cast<StreamData *>(stream->private_data);
+  if(data->batch.release != NULL) {
+    data->batch.release(&data->batch);
+  }
+  delete data;
+  stream->release = NULL;
+}
+
+// ---- Import: ArrowArrayStream -> ampl::DataFrame ----
+
+// Owns the stream and the batches read from it until the data is copied.
+struct StreamReader {
+  struct ArrowArrayStream stream;
+  struct ArrowSchema schema;
+  std::vector<struct ArrowArray> batches;
+  int64_t nrows;
+
+  StreamReader(struct ArrowArrayStream *source): nrows(0) {
+    stream = *source;
+    source->release = NULL;
+    schema.release = NULL;
+  }
+
+  void read() {
+    if(stream.get_schema(&stream, &schema) != 0) {
+      fail("failed to get the schema of the Arrow stream");
+    }
+    if(std::strcmp(schema.format, "+s") != 0) {
+      Rcpp::stop("the Arrow stream must contain struct arrays (record batches)");
+    }
+    for(;;) {
+      struct ArrowArray batch;
+      if(stream.get_next(&stream, &batch) != 0) {
+        fail("failed to read the next batch of the Arrow stream");
+      }
+      if(batch.release == NULL) {
+        break;
+      }
+      batches.push_back(batch);
+      nrows += batch.length;
+    }
+  }
+
+  ~StreamReader() {
+    for(std::size_t i = 0; i < batches.size(); i++) {
+      if(batches[i].release != NULL) {
+        batches[i].release(&batches[i]);
+      }
+    }
+    if(schema.release != NULL) {
+      schema.release(&schema);
+    }
+    if(stream.release != NULL) {
+      stream.release(&stream);
+    }
+  }
+
+  void fail(const std::string &message) {
+    const char *error = stream.get_last_error(&stream);
+    Rcpp::stop(error != NULL ? message + ": " + error : message);
+  }
+};
+
+bool isValid(const struct ArrowArray *array, int64_t i) {
+  if(array->null_count == 0 || array->buffers[0] == NULL) {
+    return true;
+  }
+  int64_t j = array->offset + i;
+  const uint8_t *bits = static_cast<const uint8_t *>(array->buffers[0]);
+  return (bits[j / 8] >> (j % 8)) & 1;
+}
+
+bool isNumericFormat(const char *format) {
+  return std::strlen(format) == 1 && std::strchr("bcCsSiIlLfg", format[0]) != NULL;
+}
+
+bool isStringFormat(const char *format) {
+  return std::strcmp(format, "u") == 0 || std::strcmp(format, "U") == 0;
+}
+
+double numberAt(const char *format, const struct ArrowArray *array, int64_t i) {
+  int64_t j = array->offset + i;
+  const void *values = array->buffers[1];
+  switch(format[0]) {
+    case 'b': return (static_cast<const uint8_t *>(values)[j / 8] >> (j % 8)) & 1;
+    case 'c': return static_cast<const int8_t *>(values)[j];
+    case 'C': return static_cast<const uint8_t *>(values)[j];
+    case 's': return static_cast<const int16_t *>(values)[j];
+    case 'S': return static_cast<const uint16_t *>(values)[j];
+    case 'i': return static_cast<const int32_t *>(values)[j];
+    case 'I': return static_cast<const uint32_t *>(values)[j];
+    case 'l': return static_cast<const int64_t *>(values)[j];
+    case 'L': return static_cast<const uint64_t *>(values)[j];
+    case 'f': return static_cast<const float *>(values)[j];
+    default: return static_cast<const double *>(values)[j];
+  }
+}
+
+void appendString(std::string &chars, const char *format, const struct ArrowArray *array, int64_t i) {
+  int64_t j = array->offset + i;
+  const char *data = static_cast<const char *>(array->buffers[2]);
+  if(format[0] == 'u') {
+    const int32_t *offsets = static_cast<const int32_t *>(array->buffers[1]);
+    chars.append(data + offsets[j], offsets[j + 1] - offsets[j]);
+  } else {
+    const int64_t *offsets = static_cast<const int64_t *>(array->buffers[1]);
+    chars.append(data + offsets[j], offsets[j + 1] - offsets[j]);
+  }
+}
+
+}  // namespace
+
+/*
+  Gets the address of an ArrowArrayStream from an external pointer (e.g.
+  nanoarrow::nanoarrow_allocate_array_stream()), or from an address given
+  as a number or a string (e.g. arrow:::allocate_arrow_array_stream()).
+*/
+struct ArrowArrayStream *arrowStream(SEXP stream) {
+  void *address = NULL;
+  switch(TYPEOF(stream)) {
+    case EXTPTRSXP:
+      address = R_ExternalPtrAddr(stream);
+      break;
+    case REALSXP:
+      if(XLENGTH(stream) == 1) {
+        address = reinterpret_cast<void *>(static_cast<uintptr_t>(REAL(stream)[0]));
+      }
+      break;
+    case STRSXP:
+      if(XLENGTH(stream) == 1) {
+        address = reinterpret_cast<void *>(static_cast<uintptr_t>(std::strtoull(CHAR(STRING_ELT(stream, 0)), NULL, 0)));
+      }
+      break;
+    default:
+      break;
+  }
+  if(address == NULL) {
+    Rcpp::stop("expected a pointer to an ArrowArrayStream");
+  }
+  return static_cast<struct ArrowArrayStream *>(address);
+}
+
+void df2arrow(const ampl::DataFrame &df, struct ArrowArrayStream *out) {
+  std::size_t nrows = df.getNumRows();
+  int ncols = df.getNumCols();
+  ampl::StringArray headers = df.getHeaders();
+  StreamData *data = new StreamData();
+  ArrayData *batchData = new ArrayData();
+  batchData->buffers.push_back(NULL);
+  for(int i = 0; i < ncols; i++) {
+    struct ArrowArray *child = new ArrowArray();
+    batchData->children.push_back(child);
+    data->formats.push_back(exportColumn(df.getColumn(headers[i]), nrows, child));
+    data->names.push_back(headers[i]);
+  }
+  struct ArrowArray &batch = data->batch;
+  batch.length = nrows;
+  batch.null_count = 0;
+  batch.offset = 0;
+  batch.n_buffers = 1;
+  batch.n_children = ncols;
+  batch.buffers = batchData->buffers.data();
+  batch.children = ncols > 0 ? batchData->children.data() : NULL;
+  batch.dictionary = NULL;
+  batch.release = releaseArray;
+  batch.private_data = batchData;
+  if(out->release != NULL) {
+    out->release(out);
+  }
+  out->get_schema = streamGetSchema;
+  out->get_next = streamGetNext;
+  out->get_last_error = streamGetLastError;
+  out->release = streamRelease;
+  out->private_data = data;
+}
+
+ampl::DataFrame arrow2df(struct ArrowArrayStream *stream, int numberOfIndexColumns) {
+  StreamReader reader(stream);
+  reader.read();
+  int ncols = reader.schema.n_children;
+  std::vector<std::string> headers(ncols);
+  std::vector<const char *> names(ncols);
+  for(int i = 0; i < ncols; i++) {
+    // The name of a field is optional in the Arrow C data interface
+    const char *name = reader.schema.children[i]->name;
+    headers[i] = name != NULL && *name != '\0' ? name : "column" + std::to_string(i);
+    names[i] = headers[i].c_str();
+  }
+  if(numberOfIndexColumns == -1) {
+    numberOfIndexColumns = ncols - 1;
+  }
+  ampl::DataFrame df(numberOfIndexColumns, ampl::StringArgs(names.data(), ncols));
+  std::size_t nrows = reader.nrows;
+  for(int c = 0; c < ncols; c++) {
+    const struct ArrowSchema *field = reader.schema.children[c];
+    const struct ArrowSchema *values = field->dictionary != NULL ? field->dictionary : field;
+    if(isStringFormat(values->format) && (field == values || isNumericFormat(field->format))) {
+      // Strings are copied once into a single buffer of NUL-terminated values
+      std::string chars;
+      std::vector<std::size_t> starts(nrows);
+      std::size_t row = 0;
+      for(std::size_t b = 0; b < reader.batches.size(); b++) {
+        const struct ArrowArray &batch = reader.batches[b];
+        const struct ArrowArray *array = batch.children[c];
+        for(int64_t i = 0; i < batch.length; i++, row++) {
+          int64_t j = batch.offset + i;
+          if(!isValid(array, j)) {
+            Rcpp::stop("null values are not supported in string columns");
+          }
+          starts[row] = chars.size();
+          if(field == values) {
+            appendString(chars, values->format, array, j);
+          } else {
+            appendString(chars, values->format, array->dictionary,
+                         static_cast<int64_t>(numberAt(field->format, array, j)));
+          }
+          chars.push_back('\0');
+        }
+      }
+      std::vector<const char *> column(nrows);
+      for(std::size_t i = 0; i < nrows; i++) {
+        column[i] = chars.data() + starts[i];
+      }
+      df.setColumn(names[c], column.data(), nrows);
+    } else if(field->dictionary == NULL && isNumericFormat(field->format)) {
+      if(reader.batches.size() == 1 && std::strcmp(field->format, "g") == 0 &&
+         reader.batches[0].children[c]->null_count == 0) {
+        const struct ArrowArray &batch = reader.batches[0];
+        const struct ArrowArray *array = batch.children[c];
+        df.setColumn(names[c], static_cast<const double *>(array->buffers[1]) + array->offset + batch.offset, nrows);
+        continue;
+      }
+      std::vector<double> column(nrows);
+      std::size_t row = 0;
+      for(std::size_t b = 0; b < reader.batches.size(); b++) {
+        const struct ArrowArray &batch = reader.batches[b];
+        const struct ArrowArray *array = batch.children[c];
+        for(int64_t i = 0; i < batch.length; i++, row++) {
+          int64_t j = batch.offset + i;
+          column[row] = isValid(array, j) ? numberAt(field->format, array, j) : NA_REAL;
+        }
+      }
+      df.setColumn(names[c], column.data(), nrows);
+    } else {
+      Rcpp::stop("unsupported Arrow type '%s' in column '%s'", field->format, names[c]);
+    }
+  }
+  return df;
+}
@@ -0,0 +1,65 @@
+#ifndef GUARD_arrow_c_h
+#define GUARD_arrow_c_h
+
+#include <stdint.h>
+#include "ampl/dataframe.h"
+#include <Rcpp.h>
+
+/*
+  Structures of the Arrow C data and stream interfaces, as published in
+  https://arrow.apache.org/docs/format/CDataInterface.html. They are ABI
+  stable, so no Arrow library is needed to produce or consume them.
+*/
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+  void (*release)(struct ArrowSchema *);
+  void *private_data;
+};
+
+struct ArrowArray {
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+  void (*release)(struct ArrowArray *);
+  void *private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+  int (*get_schema)(struct ArrowArrayStream *, struct ArrowSchema *out);
+  int (*get_next)(struct ArrowArrayStream *, struct ArrowArray *out);
+  const char *(*get_last_error)(struct ArrowArrayStream *);
+  void (*release)(struct ArrowArrayStream *);
+  void *private_data;
+};
+
+#endif  // ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream *arrowStream(SEXP stream);
+
+void df2arrow(const ampl::DataFrame &df, struct ArrowArrayStream *out);
+ampl::DataFrame arrow2df(struct ArrowArrayStream *stream, int numberOfIndexColumns = -1);
+
+#endif
@@ -1,5 +1,6 @@
 #include "rampl.h"
 #include "utils.h"
+#include "arrow_c.h"
 #include <Rcpp.h>
 /*.. _secRrefAMPL:
 .. highlight:: r
@@ -74,6 +75,9 @@ RAMPL::RAMPL(SEXP s): OHandler(NULL), EHandler(NULL), _impl(getObj<REnvironment>
   _impl.setOutputHandler(&DefOHandler);
   _impl.setErrorHandler(&DefEHandler);
 }
+RAMPL::~RAMPL() {
+  setResultCacheBudget(handle(), 0);
+}
 
 /*.. method:: AMPL.toString()
 
@@ -208,6 +212,8 @@ bool RAMPL::getBoolOption(std::string name) const {
   :raises Error: In case the file does not exist.
 */
 void RAMPL::read(std::string fileName){
+  dataChanged(handle());
+  _entities.clear();
   _impl.read(fileName);
 }
 
@@ -223,6 +229,8 @@ void RAMPL::read(std::string fileName){
   :raises Error: In case the file does not exist.
 */
 void RAMPL::readData(std::string fileName) {
+  dataChanged(handle());
+  _entities.clear();
   _impl.readData(fileName);
 }
 
@@ -238,6 +246,7 @@ void RAMPL::readData(std::string fileName) {
   :param string tableName: Name of the table to be read.
 */
 void RAMPL::readTable(std::string tableName) {
+  dataChanged(handle());
   _impl.readTable(tableName);
 }
 
@@ -279,6 +288,8 @@ void RAMPL::writeTable(std::string tableName) {
     interpreter is not running
 */
 void RAMPL::eval(std::string amplstatements) {
+  dataChanged(handle());
+  _entities.clear();
   return _impl.eval(amplstatements);
 }
 
@@ -289,6 +300,8 @@ void RAMPL::eval(std::string amplstatements) {
   and invalidates all entities.
 */
 void RAMPL::reset() {
+  dataChanged(handle());
+  _entities.clear();
   return _impl.reset();
 }
 
@@ -299,6 +312,8 @@ void RAMPL::reset() {
   optimisation commands without restarting it will throw an exception.
 */
 void RAMPL::close() {
+  dataChanged(handle());
+  _entities.clear();
   return _impl.close();
 }
 
@@ -317,6 +332,7 @@ bool RAMPL::isRunning() const {
   :raises Error: If the underlying interpreter is not running.
 */
 void RAMPL::solve() {
+  dataChanged(handle());
   _impl.solve("", "");
 }
 
@@ -328,6 +344,7 @@ void RAMPL::solve() {
   :raises Error: If the underlying interpreter is not running.
 */
 void RAMPL::solve(std::string problem) {
+  dataChanged(handle());
   _impl.solve(problem, "");
 }
 
@@ -340,6 +357,7 @@ void RAMPL::solve(std::string problem) {
   :raises Error: If the underlying interpreter is not running.
 */
 void RAMPL::solve(std::string problem, std::string solver) {
+  dataChanged(handle());
   _impl.solve(problem, solver);
 }
 
@@ -369,11 +387,26 @@ void RAMPL::solve(std::string problem, std::string solver) {
   :raises Error: if the AMPL visualization command does not succeed for one of the reasons listed above.
 */
 Rcpp::DataFrame RAMPL::getData(Rcpp::List statements) const {
+  return getCompactData(statements, false);
+}
+
+/*.. method:: AMPL.getData(statements, compact)
+
+  Equivalent to :meth:`~.AMPL.getData` but, if ``compact`` is ``TRUE``,
+  index columns with only integral values are returned as `integer` and
+  the other index columns as `factor`, with sorted levels. Value columns
+  are not changed.
+
+  :param list statements: The display statements to be fetched.
+  :param logical compact: Whether to use integer and factor columns.
+  :return: DataFrame capturing the output of the display command in tabular form.
+*/
+Rcpp::DataFrame RAMPL::getCompactData(Rcpp::List statements, bool compact) const {
   std::vector<const char *> tmp(statements.size());
   for(int i = 0; i < statements.size(); i++) {
     tmp[i] = Rcpp::as<const char *>(statements[i]);
   }
-  return df2rdf(_impl.getData(ampl::StringArgs(tmp.data(), tmp.size())));
+  return df2rdf(_impl.getData(ampl::StringArgs(tmp.data(), tmp.size())), compact);
 }
 
 /*.. method:: AMPL.getValue(scalarExpression)
@@ -399,6 +432,8 @@ SEXP RAMPL::getValue(std::string scalarExpression) const {
   :return: A string with the output.
 */
 Rcpp::String RAMPL::getOutput(std::string amplstatements) {
+  dataChanged(handle());
+  _entities.clear();
   return _impl.getOutput(amplstatements);
 }
 
@@ -408,13 +443,83 @@ Rcpp::String RAMPL::getOutput(std::string amplstatements) {
   corresponding to the column names. If setName is ``NULL``, only the
   parameters value will be assigned.
 
-  :param DataFrame df: The dataframe containing the data to be assigned.
+  :param DataFrame df: The dataframe containing the data to be assigned,
+    either a `data.frame` or an :class:`AMPLDataFrame`. The number of index
+    columns of an :class:`AMPLDataFrame` is the one it was created with.
+  :param integer numberOfIndexColumns: Number of index columns.
+  :param string setName:  The name of the set to which the indices values of the DataFrame are to be assigned.
+  :raises Error: If the data assignment procedure was not successful.
+*/
+void RAMPL::setData(SEXP data, int numberOfIndexColumns = 1, std::string setName = "") {
+  if(isAMPLDataFrame(data)) {
+    setDataFrame(getObj<RDataFrame>("AMPLDataFrame", data)->_impl, setName);
+  } else {
+    setDataFrame(rdf2df(Rcpp::DataFrame(data), numberOfIndexColumns), setName);
+  }
+}
+
+// Assigns the data, invalidating only the results of the entities it sets
+void RAMPL::setDataFrame(const ampl::DataFrame &df, const std::string &setName) {
+  ampl::StringArray headers = df.getHeaders();
+  for(std::size_t i = df.getNumIndices(); i < headers.size(); i++) {
+    dataChanged(handle(), headers[i]);
+  }
+  if(!setName.empty()) {
+    dataChanged(handle(), setName);
+  }
+  _impl.setData(df, setName);
+}
+
+/*.. method:: AMPL.getDataArrow(statements, stream)
+
+  Equivalent to :meth:`~.AMPL.getData` but exports the result through the
+  Arrow C stream interface into ``stream``, copying the data only once.
+
+  :param list statements: The display statements to be fetched.
+  :param stream: An allocated ``ArrowArrayStream`` (external pointer or address).
+*/
+void RAMPL::getArrowData(Rcpp::List statements, SEXP stream) const {
+  std::vector<const char *> tmp(statements.size());
+  for(int i = 0; i < statements.size(); i++) {
+    tmp[i] = Rcpp::as<const char *>(statements[i]);
+  }
+  df2arrow(_impl.getData(ampl::StringArgs(tmp.data(), tmp.size())), arrowStream(stream));
+}
+
+/*.. method:: AMPL.setDataArrow(stream, numberOfIndexColumns, setName)
+
+  Equivalent to :meth:`~.AMPL.setData` with the data read from an
+  ``ArrowArrayStream``. The stream is consumed and released.
+
+  :param stream: An ``ArrowArrayStream`` (external pointer or address).
   :param integer numberOfIndexColumns: Number of index columns.
   :param string setName:  The name of the set to which the indices values of the DataFrame are to be assigned.
   :raises Error: If the data assignment procedure was not successful.
 */
-void RAMPL::setData(Rcpp::DataFrame rdf, int numberOfIndexColumns = 1, std::string setName = "") {
-  _impl.setData(rdf2df(rdf, numberOfIndexColumns), setName);
+void RAMPL::setArrowData(SEXP stream, int numberOfIndexColumns, std::string setName) {
+  setDataFrame(arrow2df(arrowStream(stream), numberOfIndexColumns), setName);
+}
+
+void EntityCache::clear() {
+  variables.clear();
+  constraints.clear();
+  objectives.clear();
+  sets.clear();
+  parameters.clear();
+}
+
+// Looks up an entity in the cache, retrieving it with get() on a miss.
+template <class T, class F>
+T cachedEntity(std::unordered_map<std::string, T> &cache, EntityCache &stats, const std::string &name, F get) {
+  typename std::unordered_map<std::string, T>::iterator it = cache.find(name);
+  if(it != cache.end()) {
+    stats.hits++;
+    return it->second;
+  }
+  stats.misses++;
+  T entity = get();
+  cache.insert(std::make_pair(name, entity));
+  return entity;
 }
 
 /*.. method:: AMPL.getVariable(name)
@@ -427,7 +532,9 @@ void RAMPL::setData(Rcpp::DataFrame rdf, int numberOfIndexColumns = 1, std::stri
   :raises Error: If the specified variable does not exist.
 */
 RVariableEntity RAMPL::getVariable(std::string name) const {
-  return RVariableEntity(_impl.getVariable(name));
+  return RVariableEntity(cachedEntity(_entities.variables, _entities, name, [&]() {
+    return _impl.getVariable(name);
+  }), handle());
 }
 
 /*.. method:: AMPL.getConstraint(name)
@@ -440,7 +547,9 @@ RVariableEntity RAMPL::getVariable(std::string name) const {
   :raises Error: If the specified constraint does not exist.
 */
 RConstraintEntity RAMPL::getConstraint(std::string name) const {
-  return RConstraintEntity(_impl.getConstraint(name));
+  return RConstraintEntity(cachedEntity(_entities.constraints, _entities, name, [&]() {
+    return _impl.getConstraint(name);
+  }), handle());
 }
 
 /*.. method:: AMPL.getObjective(name)
@@ -453,7 +562,9 @@ RConstraintEntity RAMPL::getConstraint(std::string name) const {
   :raises Error: If the specified objective does not exist.
 */
 RObjectiveEntity RAMPL::getObjective(std::string name) const {
-  return RObjectiveEntity(_impl.getObjective(name));
+  return RObjectiveEntity(cachedEntity(_entities.objectives, _entities, name, [&]() {
+    return _impl.getObjective(name);
+  }), handle());
 }
 
 /*.. method:: AMPL.getSet(name)
@@ -466,7 +577,9 @@ RObjectiveEntity RAMPL::getObjective(std::string name) const {
   :raises Error: If the specified set does not exist.
 */
 RSetEntity RAMPL::getSet(std::string name) const {
-  return RSetEntity(_impl.getSet(name));
+  return RSetEntity(cachedEntity(_entities.sets, _entities, name, [&]() {
+    return _impl.getSet(name);
+  }), handle());
 }
 
 /*.. method:: AMPL.getParameter(name)
@@ -479,9 +592,93 @@ RSetEntity RAMPL::getSet(std::string name) const {
   :raises Error: If the specified parameter does not exist.
 */
 RParameterEntity RAMPL::getParameter(std::string name) const {
-  return RParameterEntity(_impl.getParameter(name));
+  return RParameterEntity(cachedEntity(_entities.parameters, _entities, name, [&]() {
+    return _impl.getParameter(name);
+  }), handle());
+}
+
+/*.. method:: AMPL.getEntityCacheStats()
+
+  Get the statistics of the cache used by :meth:`~.AMPL.getVariable`,
+  :meth:`~.AMPL.getParameter` and the other methods that get an entity
+  by name. The cache is cleared by every call that may change the
+  declarations (:meth:`~.AMPL.eval`, :meth:`~.AMPL.read`,
+  :meth:`~.AMPL.readData`, :meth:`~.AMPL.getOutput`, :meth:`~.AMPL.reset`
+  and :meth:`~.AMPL.close`).
+
+  :return: A list with the number of ``hits`` and ``misses`` since the
+    object was created and the number of entities currently cached
+    (``size``).
+*/
+Rcpp::List RAMPL::getEntityCacheStats() const {
+  std::size_t size = _entities.variables.size() + _entities.constraints.size() +
+    _entities.objectives.size() + _entities.sets.size() + _entities.parameters.size();
+  return Rcpp::List::create(
+    Rcpp::Named("hits") = static_cast<double>(_entities.hits),
+    Rcpp::Named("misses") = static_cast<double>(_entities.misses),
+    Rcpp::Named("size") = static_cast<double>(size)
+  );
+}
+
+
+// Lists the entities of a map, naming each element after its entity.
+template <class TW, class T>
+Rcpp::List entityList(const ampl::EntityMap<T> &map, ampl::AMPL *ampl) {
+  Rcpp::List list(map.size());
+  Rcpp::CharacterVector names(map.size());
+  R_xlen_t i = 0;
+  for(typename ampl::EntityMap<T>::iterator itr = map.begin(); itr != map.end(); itr++, i++) {
+    names[i] = itr->name();
+    list[i] = TW(*itr, ampl);
+  }
+  list.attr("names") = names;
+  return list;
+}
+
+// Same as entityList, optionally creating the objects on first access.
+template <class TW, class T>
+SEXP lazyEntityList(const ampl::EntityMap<T> &map, ampl::AMPL *ampl, bool lazy) {
+  if(!lazy) {
+    return entityList<TW, T>(map, ampl);
+  }
+  typedef typename ampl::EntityMap<T>::iterator iterator;
+  return lazyObjects<T>(map.begin(), map.end(), map.size(),
+    [](iterator itr) { return *itr; },
+    [ampl](const T &entity) { return TW(entity, ampl); });
 }
 
+/*.. method:: AMPL.setResultCache(budget)
+
+  Enable the cache of the results of :meth:`~.Entity.getValues`, keyed by
+  entity and suffixes, using at most ``budget`` bytes; the least recently
+  used results are evicted first. A result is invalidated when the values
+  of its entity, or of any entity it depends on (see
+  :meth:`~.Entity.xref`), are set through this package, and all results
+  are invalidated by :meth:`~.AMPL.solve`, :meth:`~.AMPL.eval`,
+  :meth:`~.AMPL.read` and the other calls that may change any data.
+  A budget of 0 disables the cache.
+
+  :param numeric budget: The memory budget in bytes.
+*/
+void RAMPL::setResultCache(double budget) {
+  setResultCacheBudget(handle(), budget);
+}
+
+/*.. method:: AMPL.getResultCacheStats()
+
+  Get the statistics of the cache enabled with :meth:`~.AMPL.setResultCache`.
+
+  :return: A list with the number of ``hits`` and ``misses``, the number of
+    cached results (``entries``), the memory they use (``bytes``) and the
+    ``budget``, or ``NULL`` if the cache is not enabled.
+*/
+SEXP RAMPL::getResultCacheStats() const {
+  ResultCache *cache = resultCache(handle());
+  if(cache == NULL) {
+    return R_NilValue;
+  }
+  return cache->stats();
+}
 
 /*.. method:: AMPL.getVariables()
 
@@ -490,14 +687,20 @@ RParameterEntity RAMPL::getParameter(std::string name) const {
   :return: List of :class:`Variable` objects.
 */
 Rcpp::List RAMPL::getVariables() const {
-  Rcpp::List list;
-  const ampl::EntityMap<ampl::Variable> map = _impl.getVariables();
-  ampl::EntityMap<ampl::Variable>::iterator begin = map.begin();
-  ampl::EntityMap<ampl::Variable>::iterator end = map.end();
-  for(ampl::EntityMap<ampl::Variable>::iterator itr = begin; itr != end; itr++){
-    list[itr->name()] = RVariableEntity(*itr);
-  }
-  return list;
+  return entityList<RVariableEntity>(_impl.getVariables(), handle());
+}
+
+/*.. method:: AMPL.getVariables(lazy)
+
+  Get all the variables declared. With ``lazy = TRUE`` only the names are
+  retrieved, and each object is created the first time it is accessed.
+
+  :param bool lazy: Whether to create the objects on demand.
+  :return: List of :class:`Variable` objects or, if ``lazy``, an environment
+    with one binding per entity.
+*/
+SEXP RAMPL::getLazyVariables(bool lazy) const {
+  return lazyEntityList<RVariableEntity>(_impl.getVariables(), handle(), lazy);
 }
 
 /*.. method:: AMPL.getConstraints()
@@ -507,14 +710,20 @@ Rcpp::List RAMPL::getVariables() const {
   :return: List of :class:`Constraint` objects.
 */
 Rcpp::List RAMPL::getConstraints() const {
-  Rcpp::List list;
-  const ampl::EntityMap<ampl::Constraint> map = _impl.getConstraints();
-  ampl::EntityMap<ampl::Constraint>::iterator begin = map.begin();
-  ampl::EntityMap<ampl::Constraint>::iterator end = map.end();
-  for(ampl::EntityMap<ampl::Constraint>::iterator itr = begin; itr != end; itr++){
-    list[itr->name()] = RConstraintEntity(*itr);
-  }
-  return list;
+  return entityList<RConstraintEntity>(_impl.getConstraints(), handle());
+}
+
+/*.. method:: AMPL.getConstraints(lazy)
+
+  Get all the constraints declared. With ``lazy = TRUE`` only the names are
+  retrieved, and each object is created the first time it is accessed.
+
+  :param bool lazy: Whether to create the objects on demand.
+  :return: List of :class:`Constraint` objects or, if ``lazy``, an environment
+    with one binding per entity.
+*/
+SEXP RAMPL::getLazyConstraints(bool lazy) const {
+  return lazyEntityList<RConstraintEntity>(_impl.getConstraints(), handle(), lazy);
 }
 
 /*.. method:: AMPL.getObjectives()
@@ -524,14 +733,20 @@ Rcpp::List RAMPL::getConstraints() const {
   :return: List of :class:`Objective` objects.
 */
 Rcpp::List RAMPL::getObjectives() const {
-  Rcpp::List list;
-  const ampl::EntityMap<ampl::Objective> map = _impl.getObjectives();
-  ampl::EntityMap<ampl::Objective>::iterator begin = map.begin();
-  ampl::EntityMap<ampl::Objective>::iterator end = map.end();
-  for(ampl::EntityMap<ampl::Objective>::iterator itr = begin; itr != end; itr++){
-    list[itr->name()] = RObjectiveEntity(*itr);
-  }
-  return list;
+  return entityList<RObjectiveEntity>(_impl.getObjectives(), handle());
+}
+
+/*.. method:: AMPL.getObjectives(lazy)
+
+  Get all the objectives declared. With ``lazy = TRUE`` only the names are
+  retrieved, and each object is created the first time it is accessed.
+
+  :param bool lazy: Whether to create the objects on demand.
+  :return: List of :class:`Objective` objects or, if ``lazy``, an environment
+    with one binding per entity.
+*/
+SEXP RAMPL::getLazyObjectives(bool lazy) const {
+  return lazyEntityList<RObjectiveEntity>(_impl.getObjectives(), handle(), lazy);
 }
 
 /*.. method:: AMPL.getSets()
@@ -541,14 +756,20 @@ Rcpp::List RAMPL::getObjectives() const {
   :return: List of :class:`Set` objects.
 */
 Rcpp::List RAMPL::getSets() const {
-  Rcpp::List list;
-  const ampl::EntityMap<ampl::Set> map = _impl.getSets();
-  ampl::EntityMap<ampl::Set>::iterator begin = map.begin();
-  ampl::EntityMap<ampl::Set>::iterator end = map.end();
-  for(ampl::EntityMap<ampl::Set>::iterator itr = begin; itr != end; itr++){
-    list[itr->name()] = RSetEntity(*itr);
-  }
-  return list;
+  return entityList<RSetEntity>(_impl.getSets(), handle());
+}
+
+/*.. method:: AMPL.getSets(lazy)
+
+  Get all the sets declared. With ``lazy = TRUE`` only the names are
+  retrieved, and each object is created the first time it is accessed.
+
+  :param bool lazy: Whether to create the objects on demand.
+  :return: List of :class:`Set` objects or, if ``lazy``, an environment
+    with one binding per entity.
+*/
+SEXP RAMPL::getLazySets(bool lazy) const {
+  return lazyEntityList<RSetEntity>(_impl.getSets(), handle(), lazy);
 }
 
 /*.. method:: AMPL.getParameters()
@@ -558,14 +779,101 @@ Rcpp::List RAMPL::getSets() const {
   :return: List of :class:`Parameter` objects.
 */
 Rcpp::List RAMPL::getParameters() const {
-  Rcpp::List list;
-  const ampl::EntityMap<ampl::Parameter> map = _impl.getParameters();
-  ampl::EntityMap<ampl::Parameter>::iterator begin = map.begin();
-  ampl::EntityMap<ampl::Parameter>::iterator end = map.end();
-  for(ampl::EntityMap<ampl::Parameter>::iterator itr = begin; itr != end; itr++){
-    list[itr->name()] = RParameterEntity(*itr);
+  return entityList<RParameterEntity>(_impl.getParameters(), handle());
+}
+
+/*.. method:: AMPL.getParameters(lazy)
+
+  Get all the parameters declared. With ``lazy = TRUE`` only the names are
+  retrieved, and each object is created the first time it is accessed.
+
+  :param bool lazy: Whether to create the objects on demand.
+  :return: List of :class:`Parameter` objects or, if ``lazy``, an environment
+    with one binding per entity.
+*/
+SEXP RAMPL::getLazyParameters(bool lazy) const {
+  return lazyEntityList<RParameterEntity>(_impl.getParameters(), handle(), lazy);
+}
+
+// Columns of the entity catalog, filled one entity at a time
+struct EntityCatalog {
+  std::vector<std::string> name, kind, indexingSets;
+  std::vector<std::size_t> indexingSetsNA;
+  std::vector<int> indexarity, isScalar, isSymbolic, isLogical;
+  std::vector<double> numInstances;
+
+  template <class T>
+  void add(const ampl::EntityMap<T> &map, const char *kindName) {
+    for(typename ampl::EntityMap<T>::iterator itr = map.begin(); itr != map.end(); itr++) {
+      name.push_back(itr->name());
+      kind.push_back(kindName);
+      indexarity.push_back(itr->indexarity());
+      isScalar.push_back(itr->isScalar());
+      // Both fail while an indexing set has no data, e.g. before readData
+      try {
+        numInstances.push_back(static_cast<double>(itr->numInstances()));
+      } catch(std::exception &) {
+        numInstances.push_back(NA_REAL);
+      }
+      try {
+        ampl::StringArray sets = itr->getIndexingSets();
+        std::string joined;
+        for(std::size_t i = 0; i < sets.size(); i++) {
+          joined += (i > 0 ? ", " : "") + std::string(sets[i]);
+        }
+        indexingSets.push_back(joined);
+      } catch(std::exception &) {
+        indexingSets.push_back(std::string());
+        indexingSetsNA.push_back(indexingSets.size() - 1);
+      }
+      isSymbolic.push_back(symbolic(*itr));
+      isLogical.push_back(logical(*itr));
+    }
   }
-  return list;
+
+  template <class T>
+  static int symbolic(const T &) { return NA_LOGICAL; }
+  static int symbolic(const ampl::Parameter &parameter) { return parameter.isSymbolic(); }
+  template <class T>
+  static int logical(const T &) { return NA_LOGICAL; }
+  static int logical(const ampl::Constraint &constraint) { return constraint.isLogical(); }
+};
+
+/*.. method:: AMPL.getEntityCatalog()
+
+  Get the metadata of all the entities declared, in a single call, without
+  creating an object per entity.
+
+  :return: A `data.frame` with one row per entity and the columns ``name``,
+    ``kind`` (``"variable"``, ``"constraint"``, ``"objective"``, ``"set"``
+    or ``"parameter"``), ``indexarity``, ``numInstances``,
+    ``indexingSets`` (separated by commas), ``isScalar``, ``isSymbolic``
+    (parameters only) and ``isLogical`` (constraints only). The number
+    of instances and the indexing sets are ``NA`` while they cannot be
+    computed, e.g. before the data of an indexing set is read.
+*/
+Rcpp::DataFrame RAMPL::getEntityCatalog() const {
+  EntityCatalog catalog;
+  catalog.add(_impl.getVariables(), "variable");
+  catalog.add(_impl.getConstraints(), "constraint");
+  catalog.add(_impl.getObjectives(), "objective");
+  catalog.add(_impl.getSets(), "set");
+  catalog.add(_impl.getParameters(), "parameter");
+  Rcpp::CharacterVector indexingSets = Rcpp::wrap(catalog.indexingSets);
+  for(std::size_t i = 0; i < catalog.indexingSetsNA.size(); i++) {
+    indexingSets[catalog.indexingSetsNA[i]] = NA_STRING;
+  }
+  return Rcpp::DataFrame::create(
+    Rcpp::Named("name") = catalog.name,
+    Rcpp::Named("kind") = catalog.kind,
+    Rcpp::Named("indexarity") = catalog.indexarity,
+    Rcpp::Named("numInstances") = catalog.numInstances,
+    Rcpp::Named("indexingSets") = indexingSets,
+    Rcpp::Named("isScalar") = Rcpp::LogicalVector(catalog.isScalar.begin(), catalog.isScalar.end()),
+    Rcpp::Named("isSymbolic") = Rcpp::LogicalVector(catalog.isSymbolic.begin(), catalog.isSymbolic.end()),
+    Rcpp::Named("isLogical") = Rcpp::LogicalVector(catalog.isLogical.begin(), catalog.isLogical.end()),
+    Rcpp::Named("stringsAsFactors") = false
+  );
 }
 
 /*.. method:: AMPL.exportModel(modfile)
@@ -681,21 +989,33 @@ RCPP_MODULE(rampl){
     .method("solve", ( void (RAMPL::*)(std::string, std::string) )(&RAMPL::solve))
 
     .method("getData", &RAMPL::getData)
+    .method("getData", &RAMPL::getCompactData)
     .method("getValue", &RAMPL::getValue)
     .method("getOutput", &RAMPL::getOutput)
     .method("setData", &RAMPL::setData)
+    .method("getDataArrow", &RAMPL::getArrowData)
+    .method("setDataArrow", &RAMPL::setArrowData)
 
     .method("getVariable", &RAMPL::getVariable, "Get the variable with the corresponding name")
     .method("getConstraint", &RAMPL::getConstraint, "Get the constraint with the corresponding name")
     .method("getObjective", &RAMPL::getObjective, "Get the objective with the corresponding name")
     .method("getSet", &RAMPL::getSet, "Get the set with the corresponding name")
     .method("getParameter", &RAMPL::getParameter, "Get the parameter with the corresponding name")
+    .method("getEntityCacheStats", &RAMPL::getEntityCacheStats, "Get the statistics of the entity cache")
+    .method("setResultCache", &RAMPL::setResultCache, "Enable the cache of getValues results")
+    .method("getResultCacheStats", &RAMPL::getResultCacheStats, "Get the statistics of the result cache")
 
     .method("getVariables", &RAMPL::getVariables, "Get all the variables declared")
+    .method("getVariables", &RAMPL::getLazyVariables, "Get all the variables declared")
     .method("getConstraints", &RAMPL::getConstraints, "Get all the constraints declared")
+    .method("getConstraints", &RAMPL::getLazyConstraints, "Get all the constraints declared")
     .method("getObjectives", &RAMPL::getObjectives, "Get all the objectives declared")
+    .method("getObjectives", &RAMPL::getLazyObjectives, "Get all the objectives declared")
     .method("getSets", &RAMPL::getSets, "Get all the sets declared")
+    .method("getSets", &RAMPL::getLazySets, "Get all the sets declared")
     .method("getParameters", &RAMPL::getParameters, "Get all the parameters declared")
+    .method("getParameters", &RAMPL::getLazyParameters, "Get all the parameters declared")
+    .method("getEntityCatalog", &RAMPL::getEntityCatalog, "Get the metadata of all the entities declared")
 
     .method("exportModel", &RAMPL::exportModel, "Export model")
     .method("exportData", &RAMPL::exportData, "Export data")
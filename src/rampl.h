@@ -2,6 +2,7 @@
 #define GUARD_RAMPL_h
 
 #include <string>
+#include <unordered_map>
 #include "ampl/ampl.h"
 #include "renvironment.h"
 #include "rvar_entity.h"
@@ -13,6 +14,8 @@
 #include "rset_entity.h"
 #include "rset_instance.h"
 #include "rparam_entity.h"
+#include "rdataframe.h"
+#include "resultcache.h"
 #include <Rcpp.h>
 
 class DefaultOutputHandler : public ampl::OutputHandler {
@@ -69,6 +72,20 @@ public:
   }
 };
 
+// Handles of the entities looked up by name, kept while the declarations
+// cannot have changed
+struct EntityCache {
+  std::unordered_map<std::string, ampl::Variable> variables;
+  std::unordered_map<std::string, ampl::Constraint> constraints;
+  std::unordered_map<std::string, ampl::Objective> objectives;
+  std::unordered_map<std::string, ampl::Set> sets;
+  std::unordered_map<std::string, ampl::Parameter> parameters;
+  unsigned long hits;
+  unsigned long misses;
+  EntityCache(): hits(0), misses(0) { }
+  void clear();
+};
+
 class RAMPL {
 private:
   // Default Output and Error handlers
@@ -78,10 +95,18 @@ private:
   // Output and Error handlers
   AMPLOutputHandler *OHandler;
   AMPLErrorHandler *EHandler;
+
+  // Handle passed to the entities for the statements they send
+  ampl::AMPL *handle() const { return const_cast<ampl::AMPL *>(&_impl); }
+
+  mutable EntityCache _entities;
+
+  void setDataFrame(const ampl::DataFrame &df, const std::string &setName);
 public:
   ampl::AMPL _impl;
   RAMPL();
   RAMPL(SEXP);
+  ~RAMPL();
 
   Rcpp::String toString() const;
 
@@ -108,21 +133,33 @@ public:
   void solve(std::string problem);
   void solve(std::string problem, std::string solver);
   Rcpp::DataFrame getData(Rcpp::List statements) const;
+  Rcpp::DataFrame getCompactData(Rcpp::List statements, bool compact) const;
   SEXP getValue(std::string scalarExpression) const;
   Rcpp::String getOutput(std::string amplstatements);
-  void setData(Rcpp::DataFrame rdf, int numberOfIndexColumns, std::string setName);
+  void setData(SEXP data, int numberOfIndexColumns, std::string setName);
+  void getArrowData(Rcpp::List statements, SEXP stream) const;
+  void setArrowData(SEXP stream, int numberOfIndexColumns, std::string setName);
 
   RVariableEntity getVariable(std::string name) const;
   RConstraintEntity getConstraint(std::string name) const;
   RObjectiveEntity getObjective(std::string name) const;
   RSetEntity getSet(std::string name) const;
   RParameterEntity getParameter(std::string name) const;
+  Rcpp::List getEntityCacheStats() const;
+  void setResultCache(double budget);
+  SEXP getResultCacheStats() const;
 
   Rcpp::List getVariables() const;
   Rcpp::List getConstraints() const;
   Rcpp::List getObjectives() const;
   Rcpp::List getSets() const;
   Rcpp::List getParameters() const;
+  SEXP getLazyVariables(bool lazy) const;
+  SEXP getLazyConstraints(bool lazy) const;
+  SEXP getLazyObjectives(bool lazy) const;
+  SEXP getLazySets(bool lazy) const;
+  SEXP getLazyParameters(bool lazy) const;
+  Rcpp::DataFrame getEntityCatalog() const;
 
   void exportModel(std::string modfile);
   void exportData(std::string datfile);
@@ -3,9 +3,16 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <memory>
+#include <functional>
 #include "ampl/ampl.h"
 #include "ampl/entity.h"
 #include "utils.h"
+#include "rvalues_iterator.h"
+#include "arrow_c.h"
+#include "rdataframe.h"
+#include "resultcache.h"
 #include <Rcpp.h>
 /*.. _secRrefEntity:
 .. highlight:: r
@@ -20,7 +27,8 @@ template <class T, class TW>
 class RBasicEntity{
 public:
   ampl::BasicEntity<T> _impl;
-  RBasicEntity(ampl::BasicEntity<T>);
+  ampl::AMPL *_ampl;
+  RBasicEntity(ampl::BasicEntity<T>, ampl::AMPL *ampl = NULL);
   std::string name() const;
   std::string toString() const;
   int indexarity() const;
@@ -30,11 +38,30 @@ public:
   std::vector<std::string> xref() const;
   Rcpp::DataFrame getSuffixValues(const Rcpp::List) const;
   Rcpp::DataFrame getValues() const;
-  void setValues(Rcpp::DataFrame);
+  Rcpp::DataFrame getCompactValues(const Rcpp::List, bool compact) const;
+  RValuesIterator valuesIterator(const Rcpp::List, int chunkSize) const;
+  void setValues(SEXP data);
+  void getArrowValues(const Rcpp::List, SEXP stream) const;
+  void setArrowValues(SEXP stream);
+  SEXP getArray() const;
+  SEXP getSuffixArray(const Rcpp::List) const;
+  void setArray(SEXP array);
+  Rcpp::List getSparse(const Rcpp::List, double eps) const;
+  SEXP getValueVector(const Rcpp::List) const;
+  Rcpp::DataFrame getIndexFrame() const;
+  void setValueVector(SEXP values);
+  void dropSubset(Rcpp::List index);
+  void restoreSubset(Rcpp::List index);
+  void dropMask(Rcpp::LogicalVector mask);
+  void restoreMask(Rcpp::LogicalVector mask);
+  void subsetStatement(const std::string &command, Rcpp::List index);
+  SEXP getMany(Rcpp::DataFrame index) const;
+  SEXP getSuffixMany(Rcpp::DataFrame index, const Rcpp::List) const;
   SEXP get(Rcpp::List index) const;
   SEXP getScalar() const;
   SEXP find(Rcpp::List index) const;
   Rcpp::List getInstances() const;
+  SEXP getLazyInstances(bool lazy) const;
 };
 
 RCPP_EXPOSED_CLASS_NODECL(ampl::VariantRef);
@@ -45,7 +72,7 @@ RCPP_EXPOSED_CLASS_NODECL(ampl::VariantRef);
 
 */
 template <class T, class TW>
-RBasicEntity<T, TW>::RBasicEntity(ampl::BasicEntity<T> impl): _impl(impl) { }
+RBasicEntity<T, TW>::RBasicEntity(ampl::BasicEntity<T> impl, ampl::AMPL *ampl): _impl(impl), _ampl(ampl) { }
 
 /*.. method:: Entity.name()
 
@@ -154,7 +181,9 @@ std::vector<std::string> RBasicEntity<T, TW>::xref() const {
 */
 template <class T, class TW>
 Rcpp::DataFrame RBasicEntity<T, TW>::getValues() const {
-  return df2rdf(_impl.getValues());
+  return cachedResult(_ampl, _impl.name(), "", [&]() {
+    return df2rdf(_impl.getValues());
+  });
 }
 
 /*.. method:: Entity.getValues(suffixes)
@@ -168,10 +197,66 @@ Rcpp::DataFrame RBasicEntity<T, TW>::getValues() const {
 template <class T, class TW>
 Rcpp::DataFrame RBasicEntity<T, TW>::getSuffixValues(Rcpp::List suffixes) const {
   std::vector<const char *> tmp(suffixes.size());
+  std::string key;
   for(int i = 0; i < suffixes.size(); i++) {
     tmp[i] = Rcpp::as<const char *>(suffixes[i]);
+    key += (i > 0 ? "," : "") + std::string(tmp[i]);
   }
-  return df2rdf(_impl.getValues(ampl::StringArgs(tmp.data(), tmp.size())));
+  return cachedResult(_ampl, _impl.name(), key, [&]() {
+    return df2rdf(_impl.getValues(ampl::StringArgs(tmp.data(), tmp.size())));
+  });
+}
+
+/*.. method:: Entity.getValues(suffixes, compact)
+
+  Get the specified suffixes value for all instances in a `data.frame`,
+  optionally in a compact representation. If ``compact`` is ``TRUE``,
+  index columns with only integral values are returned as `integer` and
+  the other index columns as `factor`, with sorted levels, which takes
+  much less memory for large entities indexed over a few distinct values.
+  Value columns are not changed. An empty list of suffixes returns the
+  principal values (see :meth:`~.Entity.getValues`).
+
+  :param list suffixes: Suffixes to get.
+  :param logical compact: Whether to use integer and factor columns.
+
+  :return: A `data.frame` containing the specified values.
+*/
+template <class T, class TW>
+Rcpp::DataFrame RBasicEntity<T, TW>::getCompactValues(Rcpp::List suffixes, bool compact) const {
+  if(suffixes.size() == 0) {
+    return df2rdf(_impl.getValues(), compact);
+  }
+  std::vector<const char *> tmp(suffixes.size());
+  for(int i = 0; i < suffixes.size(); i++) {
+    tmp[i] = Rcpp::as<const char *>(suffixes[i]);
+  }
+  return df2rdf(_impl.getValues(ampl::StringArgs(tmp.data(), tmp.size())), compact);
+}
+
+/*.. method:: Entity.valuesIterator(suffixes, chunkSize)
+
+  Get an iterator over the values of this entity that returns
+  `data.frame` chunks of at most ``chunkSize`` rows, so the whole table is
+  never held in R. An empty list of suffixes iterates over the principal
+  values (see :meth:`~.Entity.getValues`).
+
+  :param list suffixes: Suffixes to get.
+  :param integer chunkSize: Maximum number of rows in each chunk.
+
+  :return: A :class:`ValuesIterator`.
+*/
+template <class T, class TW>
+RValuesIterator RBasicEntity<T, TW>::valuesIterator(Rcpp::List suffixes, int chunkSize) const {
+  if(suffixes.size() == 0) {
+    return RValuesIterator(std::shared_ptr<ampl::DataFrame>(new ampl::DataFrame(_impl.getValues())), chunkSize);
+  }
+  std::vector<const char *> tmp(suffixes.size());
+  for(int i = 0; i < suffixes.size(); i++) {
+    tmp[i] = Rcpp::as<const char *>(suffixes[i]);
+  }
+  return RValuesIterator(std::shared_ptr<ampl::DataFrame>(
+    new ampl::DataFrame(_impl.getValues(ampl::StringArgs(tmp.data(), tmp.size())))), chunkSize);
 }
 
 /*.. method:: Entity.setValues(data)
@@ -188,11 +273,313 @@ Rcpp::DataFrame RBasicEntity<T, TW>::getSuffixValues(Rcpp::List suffixes) const
 
     let {s in S} x[s] := y[s];
 
-  :param `data.frame` data: The data to set the entity to.
+  :param `data.frame` data: The data to set the entity to, either a
+    `data.frame` or an :class:`AMPLDataFrame`.
+*/
+template <class T, class TW>
+void RBasicEntity<T, TW>::setValues(SEXP data) {
+  dataChanged(_ampl, _impl.name());
+  if(isAMPLDataFrame(data)) {
+    _impl.setValues(getObj<RDataFrame>("AMPLDataFrame", data)->_impl);
+  } else {
+    _impl.setValues(rdf2df(Rcpp::DataFrame(data)));
+  }
+}
+
+/*.. method:: Entity.getValuesArrow(suffixes, stream)
+
+  Export the specified suffixes for all instances through the Arrow C
+  stream interface, with the same columns as :meth:`~.Entity.getValues`.
+  Numeric columns are exported as ``float64`` and the others as
+  ``large_utf8``. The data is copied once, straight from AMPL into the
+  Arrow buffers. An empty list of suffixes exports the principal values.
+  For instance::
+
+    stream <- nanoarrow::nanoarrow_allocate_array_stream()
+    x$getValuesArrow(list("val"), stream)
+    tbl <- arrow::as_arrow_table(stream)
+
+  :param list suffixes: Suffixes to get.
+  :param stream: An allocated ``ArrowArrayStream`` (external pointer or address).
 */
 template <class T, class TW>
-void RBasicEntity<T, TW>::setValues(Rcpp::DataFrame data) {
-  _impl.setValues(rdf2df(data));
+void RBasicEntity<T, TW>::getArrowValues(Rcpp::List suffixes, SEXP stream) const {
+  if(suffixes.size() == 0) {
+    df2arrow(_impl.getValues(), arrowStream(stream));
+    return;
+  }
+  std::vector<const char *> tmp(suffixes.size());
+  for(int i = 0; i < suffixes.size(); i++) {
+    tmp[i] = Rcpp::as<const char *>(suffixes[i]);
+  }
+  df2arrow(_impl.getValues(ampl::StringArgs(tmp.data(), tmp.size())), arrowStream(stream));
+}
+
+/*.. method:: Entity.setValuesArrow(stream)
+
+  Equivalent to :meth:`~.Entity.setValues` with the data read from an
+  ``ArrowArrayStream``. All columns but the last are used as index, and the
+  last is used as value. The stream is consumed and released.
+
+  :param stream: An ``ArrowArrayStream`` (external pointer or address).
+*/
+template <class T, class TW>
+void RBasicEntity<T, TW>::setArrowValues(SEXP stream) {
+  dataChanged(_ampl, _impl.name());
+  _impl.setValues(arrow2df(arrowStream(stream)));
+}
+
+/*.. method:: Entity.getArray()
+
+  Get the principal values of all instances as a dense array with one
+  dimension per indexing set and the index values as ``dimnames``, in
+  the order of the members of the indexing sets (or of first appearance
+  when one set indexes several dimensions). Combinations of indices that have no instance
+  are ``NA``. A scalar entity returns a vector of length one. For
+  instance, for a parameter indexed over two sets, ``p$getArray()["a", "1"]``
+  is the value of ``p['a', 1]``.
+
+  :return: An `array` with the values.
+*/
+template <class T, class TW>
+SEXP RBasicEntity<T, TW>::getArray() const {
+  return df2array(_impl.getValues(), indexingLabels(_ampl, _impl));
+}
+
+/*.. method:: Entity.getArray(suffix)
+
+  Get the specified suffix for all instances as a dense array (see
+  :meth:`~.Entity.getArray`).
+
+  :param list suffix: List with the suffix to get.
+
+  :return: An `array` with the values.
+*/
+template <class T, class TW>
+SEXP RBasicEntity<T, TW>::getSuffixArray(Rcpp::List suffix) const {
+  if(suffix.size() != 1) {
+    Rcpp::stop("expected exactly one suffix");
+  }
+  const char *tmp = Rcpp::as<const char *>(suffix[0]);
+  return df2array(_impl.getValues(ampl::StringArgs(&tmp, 1)), indexingLabels(_ampl, _impl));
+}
+
+/*.. method:: Entity.setArray(array)
+
+  Set the values of this entity from an array with one dimension per
+  indexing set and the index values as ``dimnames``, such as the ones
+  returned by :meth:`~.Entity.getArray`. Dimension labels are sent as
+  numbers if all the labels of that dimension are numeric, and ``NA``
+  cells are skipped.
+
+  :param array array: The values to assign.
+*/
+template <class T, class TW>
+void RBasicEntity<T, TW>::setArray(SEXP array) {
+  dataChanged(_ampl, _impl.name());
+  _impl.setValues(array2df(array, _impl.name(), memberLabels(_ampl, _impl)));
+}
+
+/*.. method:: Entity.getSparse(suffixes, eps)
+
+  Get the specified suffix of an entity indexed over two sets as a sparse
+  matrix in triplet form. Only the values whose absolute value is greater
+  than ``eps`` are kept, while the dimensions and ``dimnames`` cover all
+  the indices of the entity. The result can be converted with::
+
+    m <- do.call(Matrix::sparseMatrix, x$getSparse(list("val"), 1e-9))
+
+  An empty list of suffixes returns the principal values.
+
+  :param list suffixes: List with the suffix to get.
+  :param numeric eps: Values with absolute value up to ``eps`` are dropped.
+
+  :return: A `list` with elements ``i``, ``j`` (1-based), ``x``, ``dims`` and ``dimnames``.
+*/
+template <class T, class TW>
+Rcpp::List RBasicEntity<T, TW>::getSparse(Rcpp::List suffixes, double eps) const {
+  if(suffixes.size() == 0) {
+    return df2sparse(_impl.getValues(), eps, indexingLabels(_ampl, _impl));
+  }
+  if(suffixes.size() != 1) {
+    Rcpp::stop("expected at most one suffix");
+  }
+  const char *tmp = Rcpp::as<const char *>(suffixes[0]);
+  return df2sparse(_impl.getValues(ampl::StringArgs(&tmp, 1)), eps, indexingLabels(_ampl, _impl));
+}
+
+/*.. method:: Entity.getValueVector(suffixes)
+
+  Get the specified suffix of all instances as a plain vector, without the
+  index columns. The values are in the same order as the rows of
+  :meth:`~.Entity.getIndexFrame`, which does not change while the
+  indexing sets do not change, so the index can be fetched once and the
+  values many times. An empty list of suffixes returns the principal
+  values.
+
+  :param list suffixes: List with the suffix to get.
+
+  :return: A `numeric` (or `character`) vector with one value per instance.
+*/
+template <class T, class TW>
+SEXP RBasicEntity<T, TW>::getValueVector(Rcpp::List suffixes) const {
+  if(suffixes.size() == 0) {
+    return df2valuevector(_impl.getValues());
+  }
+  if(suffixes.size() != 1) {
+    Rcpp::stop("expected at most one suffix");
+  }
+  const char *tmp = Rcpp::as<const char *>(suffixes[0]);
+  return df2valuevector(_impl.getValues(ampl::StringArgs(&tmp, 1)));
+}
+
+/*.. method:: Entity.getIndexFrame()
+
+  Get the index columns of all instances, in the order used by
+  :meth:`~.Entity.getValueVector`. Both come from the same call to
+  :meth:`~.Entity.getValues`, so the rows always match.
+
+  :return: A `data.frame` with one column per indexing set.
+*/
+template <class T, class TW>
+Rcpp::DataFrame RBasicEntity<T, TW>::getIndexFrame() const {
+  return df2indexframe(_impl.getValues());
+}
+
+/*.. method:: Entity.setValueVector(values)
+
+  Assign the principal values of all instances by position, in the order
+  of :meth:`~.Entity.getValueVector`, without matching indices in R. It is
+  available as ``setValueVector`` for variables (values) and as
+  ``setDualVector`` for constraints (duals). For instance, a warm start
+  can be loaded with::
+
+    x$setValueVector(start)
+
+  :param numeric values: One value per instance.
+*/
+template <class T, class TW>
+void RBasicEntity<T, TW>::setValueVector(SEXP values) {
+  dataChanged(_ampl, _impl.name());
+  Rcpp::DataFrame index = getIndexFrame();
+  R_xlen_t nrows = _impl.numInstances();
+  if(XLENGTH(values) != nrows) {
+    Rcpp::stop("expected %d values", static_cast<int>(nrows));
+  }
+  if(TYPEOF(values) != REALSXP && (TYPEOF(values) != INTSXP || ::Rf_isFactor(values))) {
+    Rcpp::stop("the values must be numeric");
+  }
+  int nindices = index.size();
+  Rcpp::List columns(nindices + 1);
+  Rcpp::CharacterVector names(nindices + 1);
+  Rcpp::CharacterVector indexNames = index.names();
+  for(int i = 0; i < nindices; i++) {
+    columns[i] = index[i];
+    names[i] = indexNames[i];
+  }
+  columns[nindices] = values;
+  names[nindices] = _impl.name();
+  _impl.setValues(rdf2df(makeDataFrame(columns, names, nrows), nindices));
+}
+
+/*.. method:: Entity.dropSubset(index)
+
+  Drop the instances with the specified indices in a single operation.
+  Each row of ``index`` (a `data.frame` or a list of columns) is the index
+  of one instance. Available for constraints and objectives.
+
+  :param `data.frame` index: The indices of the instances to drop.
+*/
+template <class T, class TW>
+void RBasicEntity<T, TW>::dropSubset(Rcpp::List index) {
+  subsetStatement("drop", index);
+}
+
+/*.. method:: Entity.restoreSubset(index)
+
+  Restore the instances with the specified indices in a single operation
+  (see :meth:`~.Entity.dropSubset`).
+
+  :param `data.frame` index: The indices of the instances to restore.
+*/
+template <class T, class TW>
+void RBasicEntity<T, TW>::restoreSubset(Rcpp::List index) {
+  subsetStatement("restore", index);
+}
+
+/*.. method:: Entity.dropMask(mask)
+
+  Drop the instances selected by a logical vector in the order of
+  :meth:`~.Entity.getIndexFrame`, in a single operation. Available for
+  constraints and objectives.
+
+  :param logical mask: ``TRUE`` for the instances to drop.
+*/
+template <class T, class TW>
+void RBasicEntity<T, TW>::dropMask(Rcpp::LogicalVector mask) {
+  subsetStatement("drop", subsetRows(getIndexFrame(), mask));
+}
+
+/*.. method:: Entity.restoreMask(mask)
+
+  Restore the instances selected by a logical vector in the order of
+  :meth:`~.Entity.getIndexFrame`, in a single operation.
+
+  :param logical mask: ``TRUE`` for the instances to restore.
+*/
+template <class T, class TW>
+void RBasicEntity<T, TW>::restoreMask(Rcpp::LogicalVector mask) {
+  subsetStatement("restore", subsetRows(getIndexFrame(), mask));
+}
+
+// Applies an AMPL command such as drop to the instances with the given indices
+template <class T, class TW>
+void RBasicEntity<T, TW>::subsetStatement(const std::string &command, Rcpp::List index) {
+  if(emptyIndex(index)) {
+    return;
+  }
+  dataChanged(_ampl, _impl.name());
+  TempIndex subset(_ampl, index);
+  _ampl->eval(command + " " + subset.indexing() + " " + _impl.name() + subset.subscript() + ";");
+}
+
+/*.. method:: Entity.getMany(index)
+
+  Get the principal values of the instances with the specified indices in
+  a single call. Each row of ``index`` is an index tuple, with one column
+  per indexing set. Indices without an instance, or with an ``NA``
+  element, give ``NA``. For instance::
+
+    x$getMany(data.frame(i = c(1, 2), j = c("a", "b")))
+
+  returns the values of ``x[1, 'a']`` and ``x[2, 'b']``.
+
+  :param `data.frame` index: The indices to look up.
+
+  :return: A vector with one value per row of ``index``.
+*/
+template <class T, class TW>
+SEXP RBasicEntity<T, TW>::getMany(Rcpp::DataFrame index) const {
+  return lookupValues(_impl.getValues(), index);
+}
+
+/*.. method:: Entity.getMany(index, suffix)
+
+  Get the specified suffix of the instances with the specified indices in
+  a single call (see :meth:`~.Entity.getMany`).
+
+  :param `data.frame` index: The indices to look up.
+  :param list suffix: List with the suffix to get.
+
+  :return: A vector with one value per row of ``index``.
+*/
+template <class T, class TW>
+SEXP RBasicEntity<T, TW>::getSuffixMany(Rcpp::DataFrame index, Rcpp::List suffix) const {
+  if(suffix.size() != 1) {
+    Rcpp::stop("expected exactly one suffix");
+  }
+  const char *tmp = Rcpp::as<const char *>(suffix[0]);
+  return lookupValues(_impl.getValues(ampl::StringArgs(&tmp, 1)), index);
 }
 
 /*.. method:: Entity.get(index)
@@ -209,14 +596,14 @@ void RBasicEntity<T, TW>::setValues(Rcpp::DataFrame data) {
 template <class T, class TW>
 SEXP RBasicEntity<T, TW>::get(Rcpp::List index) const {
   if(index.size() == 0) {
-    return Rcpp::wrap(TW(_impl.get()));
+    return Rcpp::wrap(wrapInstance<TW, T>(_impl.get(), _ampl));
   } else {
-    return Rcpp::wrap(TW(_impl.get(list2tuple(index))));
+    return Rcpp::wrap(wrapInstance<TW, T>(_impl.get(list2tuple(index)), _ampl));
   }
 }
 template <class T, class TW>
 SEXP RBasicEntity<T, TW>::getScalar() const {
-  return Rcpp::wrap(TW(_impl.get()));
+  return Rcpp::wrap(wrapInstance<TW, T>(_impl.get(), _ampl));
 }
 
 /*.. method:: Entity.find(index)
@@ -229,7 +616,7 @@ template <class T, class TW>
 SEXP RBasicEntity<T, TW>::find(Rcpp::List index) const {
   ampl::internal::CountedIterator<ampl::internal::EntityWrapper<T> > it = _impl.find(list2tuple(index));
   if(it != _impl.end()) {
-    return Rcpp::wrap(TW(it->second));
+    return Rcpp::wrap(wrapInstance<TW, T>(it->second, _ampl));
   } else {
     return R_NilValue;
   }
@@ -243,11 +630,42 @@ SEXP RBasicEntity<T, TW>::find(Rcpp::List index) const {
 */
 template <class T, class TW>
 Rcpp::List RBasicEntity<T, TW>::getInstances() const {
-  Rcpp::List list;
-  for(typename ampl::BasicEntity<T>::iterator it = _impl.begin(); it != _impl.end(); it++) {
-    list[it->second.name()] = TW(it->second);
+  std::size_t size = _impl.numInstances();
+  Rcpp::List list(size);
+  Rcpp::CharacterVector names(size);
+  R_xlen_t i = 0;
+  for(typename ampl::BasicEntity<T>::iterator it = _impl.begin(); it != _impl.end(); it++, i++) {
+    names[i] = it->second.name();
+    list[i] = wrapInstance<TW, T>(it->second, _ampl);
   }
+  list.attr("names") = names;
   return list;
 }
 
+/*.. method:: Entity.getInstances(lazy)
+
+  Get all the instances of this entity. With ``lazy = TRUE`` only the names
+  are retrieved, and the object for each instance is created the first
+  time it is accessed.
+
+  Not available on :class:`Parameter`: its instances are plain values,
+  returned as rows by :meth:`~.Entity.getInstances`, with no objects to
+  create on demand.
+
+  :param bool lazy: Whether to create the instance objects on demand.
+  :return: A list with all the instances of this entity or, if ``lazy``,
+    an environment with one binding per instance.
+*/
+template <class T, class TW>
+SEXP RBasicEntity<T, TW>::getLazyInstances(bool lazy) const {
+  if(!lazy) {
+    return getInstances();
+  }
+  typedef typename ampl::BasicEntity<T>::iterator iterator;
+  ampl::AMPL *ampl = _ampl;
+  return lazyObjects<T>(_impl.begin(), _impl.end(), _impl.numInstances(),
+    [](iterator it) { return it->second; },
+    [ampl](const T &instance) { return wrapInstance<TW, T>(instance, ampl); });
+}
+
 #endif
@@ -32,7 +32,7 @@ Constraint
   suffixes for that entities), see :meth:`~.Entity.getValues` and
   the :class:`DataFrame` class.
 */
-RConstraintEntity::RConstraintEntity(ampl::Constraint impl): RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>(impl), _impl(impl) { }
+RConstraintEntity::RConstraintEntity(ampl::Constraint impl, ampl::AMPL *ampl): RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>(impl, ampl), _impl(impl) { }
 
 /*.. method:: Constraint.isLogical()
 
@@ -55,7 +55,8 @@ bool RConstraintEntity::isLogical() const {
   code: `drop constraintname;`
 */
 void RConstraintEntity::drop() {
-  return _impl.drop();
+  dataChanged(_ampl, _impl.name());
+  _impl.drop();
 }
 
 /*.. method:: Constraint.restore()
@@ -64,7 +65,8 @@ void RConstraintEntity::drop() {
   AMPL code: `restore constraintname;`
 */
 void RConstraintEntity::restore() {
-  return _impl.restore();
+  dataChanged(_ampl, _impl.name());
+  _impl.restore();
 }
 
 /*.. method:: Constraint.body()
@@ -261,6 +263,7 @@ std::string RConstraintEntity::status() const {
   :param float dual: The value to be assigned to the dual variable.
 */
 void RConstraintEntity::setDual(double dual) {
+  dataChanged(_ampl, _impl.name());
   return _impl.setDual(dual);
 }
 
@@ -286,12 +289,30 @@ RCPP_MODULE(rcon_entity){
     .const_method("xref", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::xref)
     .const_method("getValues", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getSuffixValues)
     .const_method("getValues", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getValues)
+    .const_method("getValues", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getCompactValues)
     .method("setValues", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::setValues)
     .const_method("[[", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::get)
     .const_method("get", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::get)
     .const_method("get", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getScalar)
     .const_method("find", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::find)
     .const_method("getInstances", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getInstances)
+    .const_method("getInstances", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getLazyInstances)
+    .const_method("valuesIterator", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::valuesIterator)
+    .const_method("getValuesArrow", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getArrowValues)
+    .method("setValuesArrow", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::setArrowValues)
+    .const_method("getArray", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getArray)
+    .const_method("getArray", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getSuffixArray)
+    .method("setArray", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::setArray)
+    .const_method("getSparse", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getSparse)
+    .const_method("getValueVector", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getValueVector)
+    .const_method("getIndexFrame", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getIndexFrame)
+    .method("dropSubset", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::dropSubset)
+    .method("restoreSubset", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::restoreSubset)
+    .method("dropMask", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::dropMask)
+    .method("restoreMask", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::restoreMask)
+    .method("setDualVector", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::setValueVector)
+    .const_method("getMany", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getMany)
+    .const_method("getMany", &RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>::getSuffixMany)
     ;
   Rcpp::class_<RConstraintEntity>("Constraint")
     .derives<RBasicEntity<ampl::ConstraintInstance, RConstraintInstance> >("CEntity")
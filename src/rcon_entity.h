@@ -11,7 +11,7 @@
 class RConstraintEntity: public RBasicEntity<ampl::ConstraintInstance, RConstraintInstance>{
 public:
   ampl::Constraint _impl;
-  RConstraintEntity(ampl::Constraint impl);
+  RConstraintEntity(ampl::Constraint impl, ampl::AMPL *ampl = NULL);
   bool isLogical() const;
   void drop();
   void restore();
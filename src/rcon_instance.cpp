@@ -25,7 +25,7 @@ ConstraintInstance
   All the accessors in this class throw an error if the instance
   has been deleted in the underlying AMPL interpreter.
 */
-RConstraintInstance::RConstraintInstance(ampl::ConstraintInstance impl): _impl(impl) { }
+RConstraintInstance::RConstraintInstance(ampl::ConstraintInstance impl, ampl::AMPL *ampl): _impl(impl), _ampl(ampl) { }
 
 /*.. method:: ConstraintInstance.name()
 
@@ -53,7 +53,8 @@ std::string RConstraintInstance::toString() const {
   code: `drop constraintname;`
 */
 void RConstraintInstance::drop() {
-  return _impl.drop();
+  dataChanged(_ampl, _impl.name());
+  _impl.drop();
 }
 
 /*.. method:: ConstraintInstance.restore()
@@ -62,7 +63,8 @@ void RConstraintInstance::drop() {
   AMPL code: `restore constraintname;`
 */
 void RConstraintInstance::restore() {
-  return _impl.restore();
+  dataChanged(_ampl, _impl.name());
+  _impl.restore();
 }
 
 /*.. method:: ConstraintInstance.body()
@@ -258,6 +260,7 @@ std::string RConstraintInstance::status() const {
   :param float dual: The value to be assigned to the dual variable.
 */
 void RConstraintInstance::setDual(double dual) {
+  dataChanged(_ampl, _impl.name());
   return _impl.setDual(dual);
 }
 
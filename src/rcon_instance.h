@@ -11,7 +11,8 @@
 class RConstraintInstance {
 public:
   ampl::ConstraintInstance _impl;
-  RConstraintInstance(ampl::ConstraintInstance impl);
+  ampl::AMPL *_ampl;
+  RConstraintInstance(ampl::ConstraintInstance impl, ampl::AMPL *ampl = NULL);
   std::string name() const;
   std::string toString() const;
   // bool isLogical() const;
@@ -40,4 +41,9 @@ public:
 
 RCPP_EXPOSED_CLASS_NODECL(RConstraintInstance)
 
+template <>
+inline RConstraintInstance wrapInstance<RConstraintInstance, ampl::ConstraintInstance>(const ampl::ConstraintInstance &instance, ampl::AMPL *ampl) {
+  return RConstraintInstance(instance, ampl);
+}
+
 #endif
@@ -0,0 +1,120 @@
+#include "rdataframe.h"
+#include "utils.h"
+#include <Rcpp.h>
+/*.. _secRrefDataFrame:
+.. highlight:: r
+
+AMPLDataFrame
+=============
+
+*/
+
+/*.. class:: AMPLDataFrame
+
+  A table in the format used by AMPL to exchange data, kept on the C++
+  side. It is built once from a `data.frame` and can be passed to
+  :meth:`~AMPL.setData` and :meth:`~.Entity.setValues` any number of
+  times without converting the columns again. Value columns can be
+  replaced in place, so in a scenario loop only the column that changes
+  is converted::
+
+    df <- new(AMPLDataFrame, data.frame(i = 1:1000, p = 0), 1)
+    for (s in scenarios) {
+      df$setColumn("p", demand[[s]])
+      ampl$setData(df, 1, "")
+      ampl$solve()
+    }
+
+  .. method:: AMPLDataFrame(df)
+
+    Create a table from a `data.frame`, with all columns but the last as
+    index.
+
+  .. method:: AMPLDataFrame(df, numberOfIndexColumns)
+
+    Create a table from a `data.frame` with the specified number of
+    index columns.
+*/
+RDataFrame::RDataFrame(Rcpp::DataFrame rdf): _impl(rdf2df(rdf)) { }
+
+RDataFrame::RDataFrame(Rcpp::DataFrame rdf, int numberOfIndexColumns): _impl(rdf2df(rdf, numberOfIndexColumns)) { }
+
+/*.. method:: AMPLDataFrame.getNumRows()
+
+  :return: The number of rows.
+*/
+int RDataFrame::getNumRows() const {
+  return _impl.getNumRows();
+}
+
+/*.. method:: AMPLDataFrame.getNumCols()
+
+  :return: The number of columns, including the index columns.
+*/
+int RDataFrame::getNumCols() const {
+  return _impl.getNumCols();
+}
+
+/*.. method:: AMPLDataFrame.getNumIndices()
+
+  :return: The number of index columns.
+*/
+int RDataFrame::getNumIndices() const {
+  return _impl.getNumIndices();
+}
+
+/*.. method:: AMPLDataFrame.getHeaders()
+
+  :return: The headers of all the columns.
+*/
+std::vector<std::string> RDataFrame::getHeaders() const {
+  ampl::StringArray headers = _impl.getHeaders();
+  std::vector<std::string> result(headers.size());
+  for(std::size_t i = 0; i < headers.size(); i++) {
+    result[i] = headers[i];
+  }
+  return result;
+}
+
+/*.. method:: AMPLDataFrame.setColumn(header, values)
+
+  Replace the values of a column in place. Only this column is converted.
+
+  :param str header: The header of the column.
+  :param values: A `numeric`, `integer`, `character` or `factor` vector
+    with one element per row.
+*/
+void RDataFrame::setColumn(std::string header, SEXP values) {
+  std::size_t nrows = _impl.getNumRows();
+  if(static_cast<std::size_t>(XLENGTH(values)) != nrows) {
+    Rcpp::stop("expected %d values", static_cast<int>(nrows));
+  }
+  const char *name = header.c_str();
+  setColumns(_impl, Rcpp::List::create(values), &name, nrows);
+}
+
+/*.. method:: AMPLDataFrame.toDataFrame()
+
+  :return: A `data.frame` with the contents of this table.
+*/
+Rcpp::DataFrame RDataFrame::toDataFrame() const {
+  return df2rdf(_impl);
+}
+
+bool isAMPLDataFrame(SEXP data) {
+  return ::Rf_isS4(data) && Rcpp::S4(data).is("Rcpp_AMPLDataFrame");
+}
+
+// *** RCPP_MODULE ***
+RCPP_MODULE(rdataframe){
+  Rcpp::class_<RDataFrame>("AMPLDataFrame")
+    .constructor<Rcpp::DataFrame>("Create a table from a data.frame")
+    .constructor<Rcpp::DataFrame, int>("Create a table from a data.frame")
+    .method("getNumRows", &RDataFrame::getNumRows, "Get the number of rows")
+    .method("getNumCols", &RDataFrame::getNumCols, "Get the number of columns")
+    .method("getNumIndices", &RDataFrame::getNumIndices, "Get the number of index columns")
+    .method("getHeaders", &RDataFrame::getHeaders, "Get the headers of the columns")
+    .method("setColumn", &RDataFrame::setColumn, "Replace the values of a column")
+    .method("toDataFrame", &RDataFrame::toDataFrame, "Convert to a data.frame")
+    ;
+}
@@ -0,0 +1,26 @@
+#ifndef GUARD_RDataFrame_h
+#define GUARD_RDataFrame_h
+
+#include <string>
+#include <vector>
+#include "ampl/dataframe.h"
+#include <Rcpp.h>
+
+class RDataFrame {
+public:
+  ampl::DataFrame _impl;
+  RDataFrame(Rcpp::DataFrame rdf);
+  RDataFrame(Rcpp::DataFrame rdf, int numberOfIndexColumns);
+  int getNumRows() const;
+  int getNumCols() const;
+  int getNumIndices() const;
+  std::vector<std::string> getHeaders() const;
+  void setColumn(std::string header, SEXP values);
+  Rcpp::DataFrame toDataFrame() const;
+};
+
+RCPP_EXPOSED_CLASS(RDataFrame)
+
+bool isAMPLDataFrame(SEXP data);
+
+#endif
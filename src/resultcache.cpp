@@ -0,0 +1,178 @@
+#include "resultcache.h"
+#include <memory>
+#include <Rcpp.h>
+
+namespace {
+
+std::unordered_map<ampl::AMPL *, std::unique_ptr<ResultCache> > caches;
+
+// Approximate memory used by a result
+std::size_t objectSize(SEXP x) {
+  R_xlen_t n = Rf_xlength(x);
+  switch(TYPEOF(x)) {
+    case VECSXP: {
+      std::size_t size = n * sizeof(SEXP);
+      for(R_xlen_t i = 0; i < n; i++) {
+        size += objectSize(VECTOR_ELT(x, i));
+      }
+      return size;
+    }
+    case STRSXP: {
+      std::size_t size = n * sizeof(SEXP);
+      for(R_xlen_t i = 0; i < n; i++) {
+        size += LENGTH(STRING_ELT(x, i));
+      }
+      return size;
+    }
+    case REALSXP:
+      return n * sizeof(double);
+    case INTSXP:
+    case LGLSXP:
+      return n * sizeof(int);
+    default:
+      return 0;
+  }
+}
+
+// Cached results are shared, so R has to copy them before any change
+void markNotMutable(SEXP x) {
+  MARK_NOT_MUTABLE(x);
+  if(TYPEOF(x) == VECSXP) {
+    for(R_xlen_t i = 0; i < Rf_xlength(x); i++) {
+      MARK_NOT_MUTABLE(VECTOR_ELT(x, i));
+    }
+  }
+}
+
+std::string entryKey(const std::string &entity, const std::string &key) {
+  return entity + '\n' + key;
+}
+
+}  // namespace
+
+ResultCache::ResultCache(double budget): _size(0), _hits(0), _misses(0) {
+  setBudget(budget);
+}
+
+SEXP ResultCache::find(const std::string &entity, const std::string &key) {
+  std::unordered_map<std::string, std::list<Entry>::iterator>::iterator it = _index.find(entryKey(entity, key));
+  if(it == _index.end()) {
+    _misses++;
+    return NULL;
+  }
+  _hits++;
+  _entries.splice(_entries.begin(), _entries, it->second);
+  return it->second->value;
+}
+
+void ResultCache::insert(const std::string &entity, const std::string &key, SEXP value) {
+  std::size_t size = objectSize(value);
+  if(size > _budget) {
+    return;
+  }
+  std::string k = entryKey(entity, key);
+  std::unordered_map<std::string, std::list<Entry>::iterator>::iterator it = _index.find(k);
+  if(it != _index.end()) {
+    _size -= it->second->size;
+    _entries.erase(it->second);
+    _index.erase(it);
+  }
+  evict(size);
+  markNotMutable(value);
+  Entry entry = {entity, key, Rcpp::RObject(value), size};
+  _entries.push_front(entry);
+  _index[k] = _entries.begin();
+  _size += size;
+}
+
+void ResultCache::invalidate(const std::string &entity) {
+  for(std::list<Entry>::iterator it = _entries.begin(); it != _entries.end(); ) {
+    if(it->entity == entity) {
+      _size -= it->size;
+      _index.erase(entryKey(it->entity, it->key));
+      it = _entries.erase(it);
+    } else {
+      it++;
+    }
+  }
+}
+
+void ResultCache::clear() {
+  _entries.clear();
+  _index.clear();
+  _size = 0;
+}
+
+bool ResultCache::empty() const {
+  return _entries.empty();
+}
+
+void ResultCache::setBudget(double budget) {
+  _budget = budget > 0 ? static_cast<std::size_t>(budget) : 0;
+  evict(0);
+}
+
+// Removes the least recently used results until size more bytes fit
+void ResultCache::evict(std::size_t size) {
+  while(!_entries.empty() && _size + size > _budget) {
+    Entry &last = _entries.back();
+    _size -= last.size;
+    _index.erase(entryKey(last.entity, last.key));
+    _entries.pop_back();
+  }
+}
+
+Rcpp::List ResultCache::stats() const {
+  return Rcpp::List::create(
+    Rcpp::Named("hits") = static_cast<double>(_hits),
+    Rcpp::Named("misses") = static_cast<double>(_misses),
+    Rcpp::Named("entries") = static_cast<double>(_entries.size()),
+    Rcpp::Named("bytes") = static_cast<double>(_size),
+    Rcpp::Named("budget") = static_cast<double>(_budget)
+  );
+}
+
+ResultCache *resultCache(ampl::AMPL *ampl) {
+  if(ampl == NULL) {
+    return NULL;
+  }
+  std::unordered_map<ampl::AMPL *, std::unique_ptr<ResultCache> >::iterator it = caches.find(ampl);
+  return it == caches.end() ? NULL : it->second.get();
+}
+
+void setResultCacheBudget(ampl::AMPL *ampl, double budget) {
+  if(budget <= 0) {
+    caches.erase(ampl);
+  } else if(ResultCache *cache = resultCache(ampl)) {
+    cache->setBudget(budget);
+  } else {
+    caches[ampl].reset(new ResultCache(budget));
+  }
+}
+
+void invalidateResults(ampl::AMPL *ampl, const std::string &entity) {
+  for(std::unordered_map<ampl::AMPL *, std::unique_ptr<ResultCache> >::iterator it = caches.begin(); it != caches.end(); it++) {
+    ResultCache &cache = *it->second;
+    if((ampl != NULL && it->first != ampl) || cache.empty()) {
+      continue;
+    }
+    if(entity.empty()) {
+      cache.clear();
+      continue;
+    }
+    // Instances invalidate the whole entity
+    std::string name = entity.substr(0, entity.find('['));
+    cache.invalidate(name);
+    if(cache.empty()) {
+      continue;
+    }
+    try {
+      ampl::StringArray dependents = it->first->getEntity(name).xref();
+      for(std::size_t i = 0; i < dependents.size(); i++) {
+        cache.invalidate(dependents[i]);
+      }
+    } catch(std::exception &) {
+      cache.clear();
+    }
+  }
+}
@@ -0,0 +1,64 @@
+#ifndef GUARD_resultcache_h
+#define GUARD_resultcache_h
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include "ampl/ampl.h"
+#include <Rcpp.h>
+
+/*
+  Results of getValues kept per AMPL object, keyed by entity and suffixes,
+  within a memory budget. The least recently used results are evicted
+  first. Results are invalidated through dataChanged (see utils.h).
+*/
+class ResultCache {
+public:
+  ResultCache(double budget);
+  SEXP find(const std::string &entity, const std::string &key);
+  void insert(const std::string &entity, const std::string &key, SEXP value);
+  void invalidate(const std::string &entity);
+  void clear();
+  bool empty() const;
+  void setBudget(double budget);
+  Rcpp::List stats() const;
+private:
+  struct Entry {
+    std::string entity;
+    std::string key;
+    Rcpp::RObject value;
+    std::size_t size;
+  };
+  void evict(std::size_t size);
+  std::list<Entry> _entries;  // most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+  std::size_t _budget;
+  std::size_t _size;
+  unsigned long _hits;
+  unsigned long _misses;
+};
+
+// Cache of the specified AMPL object, or NULL if caching is not enabled
+ResultCache *resultCache(ampl::AMPL *ampl);
+// Enables caching with the specified budget in bytes, or disables it if 0
+void setResultCacheBudget(ampl::AMPL *ampl, double budget);
+// Invalidates the results of an entity and of the entities depending on it,
+// all results if entity is empty, in all caches if ampl is NULL
+void invalidateResults(ampl::AMPL *ampl, const std::string &entity);
+
+template <class F>
+SEXP cachedResult(ampl::AMPL *ampl, const std::string &entity, const std::string &key, F compute) {
+  ResultCache *cache = resultCache(ampl);
+  if(cache == NULL) {
+    return compute();
+  }
+  SEXP value = cache->find(entity, key);
+  if(value != NULL) {
+    return value;
+  }
+  Rcpp::RObject result = compute();
+  cache->insert(entity, key, result);
+  return result;
+}
+
+#endif
@@ -25,7 +25,7 @@ Objective
   suffixes for that entities), see :meth:`~.Entity.getValues` and the
   :class:`DataFrame` class.
 */
-RObjectiveEntity::RObjectiveEntity(ampl::Objective impl): RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>(impl), _impl(impl) { }
+RObjectiveEntity::RObjectiveEntity(ampl::Objective impl, ampl::AMPL *ampl): RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>(impl, ampl), _impl(impl) { }
 
 /*.. method:: Objective.value()
 
@@ -93,7 +93,8 @@ std::string RObjectiveEntity::result() const {
   Drop this objective.
 */
 void RObjectiveEntity::drop() {
-  return _impl.drop();
+  dataChanged(_ampl, _impl.name());
+  _impl.drop();
 }
 
 /*.. method:: Objective.restore()
@@ -101,7 +102,8 @@ void RObjectiveEntity::drop() {
   Restore this objective  (if it had been dropped, no effect otherwise)
 */
 void RObjectiveEntity::restore() {
-  return _impl.restore();
+  dataChanged(_ampl, _impl.name());
+  _impl.restore();
 }
 
 /*.. method:: Objective.message()
@@ -126,12 +128,29 @@ RCPP_MODULE(robj_entity){
     .const_method("xref", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::xref)
     .const_method("getValues", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getSuffixValues)
     .const_method("getValues", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getValues)
+    .const_method("getValues", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getCompactValues)
     .method("setValues", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::setValues)
     .const_method("[[", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::get)
     .const_method("get", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::get)
     .const_method("get", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getScalar)
     .const_method("find", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::find)
     .const_method("getInstances", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getInstances)
+    .const_method("getInstances", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getLazyInstances)
+    .const_method("valuesIterator", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::valuesIterator)
+    .const_method("getValuesArrow", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getArrowValues)
+    .method("setValuesArrow", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::setArrowValues)
+    .const_method("getArray", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getArray)
+    .const_method("getArray", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getSuffixArray)
+    .method("setArray", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::setArray)
+    .const_method("getSparse", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getSparse)
+    .const_method("getValueVector", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getValueVector)
+    .const_method("getIndexFrame", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getIndexFrame)
+    .method("dropSubset", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::dropSubset)
+    .method("restoreSubset", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::restoreSubset)
+    .method("dropMask", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::dropMask)
+    .method("restoreMask", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::restoreMask)
+    .const_method("getMany", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getMany)
+    .const_method("getMany", &RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>::getSuffixMany)
     ;
   Rcpp::class_<RObjectiveEntity>("Objective")
     .derives<RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance> >("OEntity")
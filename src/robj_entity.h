@@ -11,7 +11,7 @@
 class RObjectiveEntity: public RBasicEntity<ampl::ObjectiveInstance, RObjectiveInstance>{
 public:
   ampl::Objective _impl;
-  RObjectiveEntity(ampl::Objective impl);
+  RObjectiveEntity(ampl::Objective impl, ampl::AMPL *ampl = NULL);
   double value() const;
   std::string astatus() const;
   std::string sstatus() const;
@@ -25,7 +25,7 @@ ObjectiveInstance
   suffixes for that entities), see :meth:`~.Entity.getValues` and the
   :class:`DataFrame` class.
 */
-RObjectiveInstance::RObjectiveInstance(ampl::ObjectiveInstance impl): _impl(impl) { }
+RObjectiveInstance::RObjectiveInstance(ampl::ObjectiveInstance impl, ampl::AMPL *ampl): _impl(impl), _ampl(ampl) { }
 
 /*.. method:: ObjectiveInstance.name()
 
@@ -113,7 +113,8 @@ std::string RObjectiveInstance::result() const {
   Drop this objective.
 */
 void RObjectiveInstance::drop() {
-  return _impl.drop();
+  dataChanged(_ampl, _impl.name());
+  _impl.drop();
 }
 
 /*.. method:: ObjectiveInstance.restore()
@@ -121,7 +122,8 @@ void RObjectiveInstance::drop() {
   Restore this objective  (if it had been dropped, no effect otherwise)
 */
 void RObjectiveInstance::restore() {
-  return _impl.restore();
+  dataChanged(_ampl, _impl.name());
+  _impl.restore();
 }
 
 /*.. method:: ObjectiveInstance.message()
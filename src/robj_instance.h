@@ -3,12 +3,14 @@
 
 #include <string>
 #include "ampl/entity.h"
+#include "utils.h"
 #include <Rcpp.h>
 
 class RObjectiveInstance {
 public:
   ampl::ObjectiveInstance _impl;
-  RObjectiveInstance(ampl::ObjectiveInstance impl);
+  ampl::AMPL *_ampl;
+  RObjectiveInstance(ampl::ObjectiveInstance impl, ampl::AMPL *ampl = NULL);
   std::string name() const;
   std::string toString() const;
   double value() const;
@@ -24,4 +26,9 @@ public:
 
 RCPP_EXPOSED_CLASS(RObjectiveInstance)
 
+template <>
+inline RObjectiveInstance wrapInstance<RObjectiveInstance, ampl::ObjectiveInstance>(const ampl::ObjectiveInstance &instance, ampl::AMPL *ampl) {
+  return RObjectiveInstance(instance, ampl);
+}
+
 #endif
@@ -19,7 +19,7 @@ Parameter
   using :meth:`~AMPL.setData` and an object of class
   :class:`~DataFrame`.
 */
-RParameterEntity::RParameterEntity(ampl::Parameter impl): RBasicEntity<ampl::VariantRef, ampl::VariantRef>(impl), _impl(impl) { }
+RParameterEntity::RParameterEntity(ampl::Parameter impl, ampl::AMPL *ampl): RBasicEntity<ampl::VariantRef, ampl::VariantRef>(impl, ampl), _impl(impl) { }
 
 /*.. method:: Parameter.isSymbolic()
 
@@ -59,33 +59,35 @@ bool RParameterEntity::hasDefault() const {
   If the argument is a `data.frame`,
   set the values of this parameter to the correponding values of the `data.frame`
   indexed over the same sets (or a subset). All columns but the last are used as index, and the last is used as value.
+  An :class:`AMPLDataFrame` is used as is.
 
   :param list/data.frame values: An array of indices of the instances to be set.
 */
-void RParameterEntity::setValues(Rcpp::DataFrame df) {
+void RParameterEntity::setValues(SEXP values) {
+  dataChanged(_ampl, _impl.name());
+  if(isAMPLDataFrame(values)) {
+    _impl.setValues(getObj<RDataFrame>("AMPLDataFrame", values)->_impl);
+    return;
+  }
+  Rcpp::DataFrame df(values);
   if(df.length() == 1){
-    switch(TYPEOF(df[0])) {
+    SEXP column = df[0];
+    switch(TYPEOF(column)) {
       case REALSXP:
-        _impl.setValues(Rcpp::as<std::vector<double> >(df[0]).data(), df.nrows());
+        _impl.setValues(REAL(column), df.nrows());
         break;
       case INTSXP:
-        if(::Rf_isFactor(df[0]) == false) {
-          _impl.setValues(Rcpp::as<std::vector<double> >(df[0]).data(), df.nrows());
+        if(::Rf_isFactor(column) == false) {
+          std::vector<double> buffer;
+          _impl.setValues(dblColumn(column, buffer), df.nrows());
         } else {
-          Rcpp::IntegerVector iv = df[0];
-          std::vector<const char *> values(iv.size());
-          std::vector<std::string > levels = Rcpp::as<std::vector<std::string> >(iv.attr("levels"));
-          for(int i = 0; i < iv.size(); i++) values[i] = levels[iv[i]-1].c_str();
-          _impl.setValues(values.data(), values.size());
+          std::vector<const char *> buffer;
+          _impl.setValues(strColumn(column, buffer), df.nrows());
         }
         break;
       case STRSXP: {
-          Rcpp::StringVector iv = df[0];
-          std::vector<const char *> values(iv.size());
-          for(int i = 0; i < iv.size(); i++) {
-            values[i] = iv[i];
-          }
-          _impl.setValues(values.data(), values.size());
+          std::vector<const char *> buffer;
+          _impl.setValues(strColumn(column, buffer), df.nrows());
         }
         break;
 	    default:
@@ -97,7 +99,23 @@ void RParameterEntity::setValues(Rcpp::DataFrame df) {
 }
 
 Rcpp::DataFrame RParameterEntity::getValues() const {
-  return df2rdf(_impl.getValues());
+  return cachedResult(_ampl, _impl.name(), "", [&]() {
+    return df2rdf(_impl.getValues());
+  });
+}
+
+/*.. method:: Parameter.getValues(compact)
+
+  Get the values of this parameter in a `data.frame`. If ``compact`` is
+  ``TRUE``, index columns with only integral values are returned as
+  `integer` and the other index columns as `factor`, with sorted levels.
+  Value columns are not changed.
+
+  :param logical compact: Whether to use integer and factor columns.
+  :return: A `data.frame` containing the values of this parameter.
+*/
+Rcpp::DataFrame RParameterEntity::getCompactValues(bool compact) const {
+  return df2rdf(_impl.getValues(), compact);
 }
 
 /*.. method:: Parameter.value()
@@ -120,6 +138,7 @@ SEXP RParameterEntity::value() const {
   :param value: Value to be assigned.
 */
 void RParameterEntity::set(SEXP value) {
+  dataChanged(_ampl, _impl.name());
   switch(TYPEOF(value)) {
     case REALSXP:
       _impl.set(Rcpp::as<double>(value));
@@ -143,6 +162,7 @@ void RParameterEntity::set(SEXP value) {
   :param value: Value to be assigned.
 */
 void RParameterEntity::setIndVal(Rcpp::List index, SEXP value) {
+  dataChanged(_ampl, _impl.name());
   switch(TYPEOF(value)) {
     case REALSXP:
       _impl.set(list2tuple(index), Rcpp::as<double>(value));
@@ -155,6 +175,23 @@ void RParameterEntity::setIndVal(Rcpp::List index, SEXP value) {
   }
 }
 
+/*.. method:: Parameter.setSparse(matrix)
+
+  Assign the entries of a sparse matrix to a parameter indexed over two
+  sets. The matrix can be a ``dgTMatrix`` or ``dgCMatrix`` from the
+  ``Matrix`` package, or a list with elements ``i``, ``j`` (1-based), ``x``
+  and ``dimnames`` as returned by :meth:`~.Entity.getSparse`. The
+  ``dimnames`` give the indices; labels are sent as numbers if all the
+  labels of that dimension are numeric. Only the stored entries are
+  assigned, so the other instances keep their current (or default) values.
+
+  :param matrix: The sparse matrix to assign.
+*/
+void RParameterEntity::setSparse(SEXP matrix) {
+  dataChanged(_ampl, _impl.name());
+  _impl.setValues(sparse2df(matrix, _impl.name(), memberLabels(_ampl, _impl)));
+}
+
 // RBasicEntity<ampl::VariantRef, ampl::VariantRef>
 template <>
 SEXP RBasicEntity<ampl::VariantRef, ampl::VariantRef>::get(Rcpp::List index) const {
@@ -176,13 +213,16 @@ SEXP RBasicEntity<ampl::VariantRef, ampl::VariantRef>::find(Rcpp::List index) co
   }
 }
 
+// Instances of parameters are values, so each is returned as a row of
+// index and value, and there is no lazy getInstances
 template <>
 Rcpp::List RBasicEntity<ampl::VariantRef, ampl::VariantRef>::getInstances() const {
-  Rcpp::List list;
-  for(ampl::BasicEntity<ampl::VariantRef>::iterator it = _impl.begin(); it != _impl.end(); it++) {
+  Rcpp::List list(_impl.numInstances());
+  R_xlen_t i = 0;
+  for(ampl::BasicEntity<ampl::VariantRef>::iterator it = _impl.begin(); it != _impl.end(); it++, i++) {
     Rcpp::List row = tuple2list(it->first);
     row.push_back(variant2sexp(it->second));
-    list.push_back(row);
+    list[i] = row;
   }
   return list;
 }
@@ -205,6 +245,17 @@ RCPP_MODULE(rparam_entity){
     .const_method("get", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::getScalar)
     .const_method("find", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::find)
     .const_method("getInstances", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::getInstances)
+    .const_method("valuesIterator", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::valuesIterator)
+    .const_method("getValuesArrow", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::getArrowValues)
+    .method("setValuesArrow", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::setArrowValues)
+    .const_method("getArray", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::getArray)
+    .const_method("getArray", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::getSuffixArray)
+    .method("setArray", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::setArray)
+    .const_method("getSparse", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::getSparse)
+    .const_method("getValueVector", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::getValueVector)
+    .const_method("getIndexFrame", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::getIndexFrame)
+    .const_method("getMany", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::getMany)
+    .const_method("getMany", &RBasicEntity<ampl::VariantRef, ampl::VariantRef>::getSuffixMany)
     ;
   Rcpp::class_<RParameterEntity>("Parameter")
     .derives<RBasicEntity<ampl::VariantRef, ampl::VariantRef> >("PEntity")
@@ -212,8 +263,10 @@ RCPP_MODULE(rparam_entity){
     .method("isSymbolic", &RParameterEntity::isSymbolic, "Returns true if the parameter is declared as symbolic")
     .method("setValues", &RParameterEntity::setValues, "Assign the specified values to this parameter")
     .method("getValues", &RParameterEntity::getValues, "Get the values of this parameter")
+    .method("getValues", &RParameterEntity::getCompactValues, "Get the values of this parameter")
     .method("value", &RParameterEntity::value, "Get the value of a scalar parameter")
     .method("set", &RParameterEntity::setIndVal, "Set the value of an indexed parameter")
     .method("set", &RParameterEntity::set, "Set the value of a scalar parameter")
+    .method("setSparse", &RParameterEntity::setSparse, "Assign the values of a sparse matrix to this parameter")
     ;
 }
@@ -9,14 +9,16 @@
 class RParameterEntity: public RBasicEntity<ampl::VariantRef, ampl::VariantRef>{
 public:
   ampl::Parameter _impl;
-  RParameterEntity(ampl::Parameter impl);
+  RParameterEntity(ampl::Parameter impl, ampl::AMPL *ampl = NULL);
   bool isSymbolic() const;
   bool hasDefault() const;
-  void setValues(Rcpp::DataFrame df);
+  void setValues(SEXP values);
   Rcpp::DataFrame getValues() const;
+  Rcpp::DataFrame getCompactValues(bool compact) const;
   SEXP value() const;
   void set(SEXP value);
   void setIndVal(Rcpp::List index, SEXP value);
+  void setSparse(SEXP matrix);
 };
 
 RCPP_EXPOSED_CLASS_NODECL(RParameterEntity)
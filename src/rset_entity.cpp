@@ -27,7 +27,7 @@ Set
   :class:`~DataFrame`.
 
 */
-RSetEntity::RSetEntity(ampl::Set impl):  RBasicEntity<ampl::SetInstance, RSetInstance>(impl), _impl(impl) { }
+RSetEntity::RSetEntity(ampl::Set impl, ampl::AMPL *ampl): RBasicEntity<ampl::SetInstance, RSetInstance>(impl, ampl), _impl(impl) { }
 
 /*.. method:: Set.arity()
 
@@ -55,13 +55,64 @@ int RSetEntity::size() const {
 
   :return: The list of members of the set.
 */
-std::vector<Rcpp::List> RSetEntity::members() const {
-  std::vector<Rcpp::List> members;
-  ampl::SetInstance::MemberRange range = _impl.members();
-  for(ampl::SetInstance::MemberRange::iterator it = range.begin(); it != range.end(); it++){
-    members.push_back(tuple2list(*it));
+Rcpp::List RSetEntity::members() const {
+  return members2list(_impl.members(), _impl.size());
+}
+
+/*.. method:: Set.membersColumns()
+
+  Get the members of this set by columns, with one vector per component
+  of the tuples, instead of one list per member. It takes much less time
+  and memory than :meth:`~Set.members` for large sets. Valid only for non
+  indexed sets.
+
+  :return: A list with one `numeric` or `character` vector per component.
+*/
+Rcpp::List RSetEntity::membersColumns() const {
+  return members2columns(_impl.members(), _impl.size(), _impl.arity());
+}
+
+/*.. method:: Set.getAllMembers()
+
+  Get the members of all the instances of this set in a single
+  `data.frame`, with the index of the instance in the first columns
+  (``index0``, ``index1``, ...) followed by the components of the members
+  (``member0``, ...). Works for indexed and non indexed sets.
+
+  :return: A `data.frame` with one row per member of each instance.
+*/
+Rcpp::DataFrame RSetEntity::getAllMembers() const {
+  int indexarity = _impl.indexarity();
+  int arity = _impl.arity();
+  std::size_t nrows = 0;
+  for(ampl::BasicEntity<ampl::SetInstance>::iterator it = _impl.begin(); it != _impl.end(); it++) {
+    nrows += it->second.size();
   }
-  return members;
+  std::vector<ColumnBuilder> builders;
+  for(int i = 0; i < indexarity + arity; i++) {
+    builders.push_back(ColumnBuilder(nrows));
+  }
+  std::size_t row = 0;
+  for(ampl::BasicEntity<ampl::SetInstance>::iterator it = _impl.begin(); it != _impl.end(); it++) {
+    ampl::TupleRef index = it->first;
+    ampl::SetInstance::MemberRange range = it->second.members();
+    for(ampl::SetInstance::MemberRange::iterator m = range.begin(); m != range.end(); m++, row++) {
+      for(int i = 0; i < indexarity; i++) {
+        builders[i].set(row, index[i]);
+      }
+      ampl::TupleRef member = *m;
+      for(int i = 0; i < arity; i++) {
+        builders[indexarity + i].set(row, member[i]);
+      }
+    }
+  }
+  Rcpp::List columns(indexarity + arity);
+  Rcpp::CharacterVector names(indexarity + arity);
+  for(int i = 0; i < indexarity + arity; i++) {
+    columns[i] = builders[i].get();
+    names[i] = i < indexarity ? "index" + std::to_string(i) : "member" + std::to_string(i - indexarity);
+  }
+  return makeDataFrame(columns, names, nrows);
 }
 
 /*.. method:: Set.contains(tuple)
@@ -74,6 +125,26 @@ bool RSetEntity::contains(Rcpp::List tuple) const {
   return _impl.contains(list2tuple(tuple));
 }
 
+/*.. method:: Set.containsMany(tuples)
+
+  Check which rows of a `data.frame` are members of this set, with one
+  column per component of the set tuples. The members are hashed on the
+  first call and the index is reused until the data in AMPL changes.
+  Rows with an ``NA`` element are not members.
+
+  :param `data.frame` tuples: The tuples to check.
+  :return: A `logical` vector with one element per row of ``tuples``.
+*/
+Rcpp::LogicalVector RSetEntity::containsMany(Rcpp::DataFrame tuples) const {
+  if(!_index || !_index->isCurrent()) {
+    if(!_index) {
+      _index.reset(new MemberIndex());
+    }
+    _index->build(_impl.members());
+  }
+  return _index->contains(tuples);
+}
+
 /*.. method:: Set.getValues()
 
   Get values of this set in a data.frame. Valid only for non indexed sets.
@@ -84,14 +155,37 @@ Rcpp::DataFrame RSetEntity::getValues() const {
   return df2rdf(_impl.getValues());
 }
 
+/*.. method:: Set.getValues(compact)
+
+  Get values of this set in a data.frame, optionally with integral columns
+  as `integer` and the other columns as `factor`, with sorted levels.
+  Valid only for non indexed sets.
+
+  :param logical compact: Whether to use integer and factor columns.
+  :return: `data.frame` containing the values of this set.
+*/
+Rcpp::DataFrame RSetEntity::getCompactValues(bool compact) const {
+  return df2rdf(_impl.getValues(), compact);
+}
+
 /*.. method:: Set.setValues(values)
 
-  Set values. Valid only for non indexed sets.
+  Set values. Valid only for non indexed sets. Integer vectors made of
+  a few runs of consecutive values, such as ``1:1e7``, are sent as ranges
+  (``lo..hi``) without expanding them.
 */
 void RSetEntity::setValues(SEXP values) {
+  dataChanged(_ampl, _impl.name());
   if(::Rf_inherits(values, "data.frame")) {
     Rcpp::DataFrame rdf = values;
+    if(rdf.size() == 1 && setMemberRanges(_ampl, _impl.name(), rdf[0])) {
+      return;
+    }
     _impl.setValues(rdf2df(rdf, rdf.size()));
+  } else if(::Rf_isVectorAtomic(values)) {
+    if(!setMemberRanges(_ampl, _impl.name(), values)) {
+      setMemberColumns(_impl, Rcpp::List::create(values), 0);
+    }
   } else {
     setValuesList(values);
   }
@@ -105,6 +199,44 @@ void RSetEntity::setValuesList(Rcpp::List values) {
   return _impl.setValues(objects.data(), objects.size());
 }
 
+/*.. method:: Set.setMembers(columns)
+
+  Set the members of this set from a list (or `data.frame`) with one
+  vector per component of the tuples, e.g. ``s$setMembers(list(from, to))``.
+  The columns can be `numeric`, `integer`, `character` or `factor`, and are
+  passed to AMPL without building a list per member. Valid only for non
+  indexed sets.
+
+  :param list columns: The components of the members.
+*/
+void RSetEntity::setMembers(Rcpp::List columns) {
+  dataChanged(_ampl, _impl.name());
+  setMemberColumns(_impl, columns, 0);
+}
+
+/*.. method:: Set.addMembers(columns)
+
+  Add members to this set, with the same columns as
+  :meth:`~Set.setMembers`. Only the new members are sent to AMPL, which
+  checks them all at once. Members already in the set are ignored.
+
+  :param list columns: The components of the members to add.
+*/
+void RSetEntity::addMembers(Rcpp::List columns) {
+  updateMembers(_ampl, _impl.name(), columns, "union");
+}
+
+/*.. method:: Set.removeMembers(columns)
+
+  Remove members from this set, with the same columns as
+  :meth:`~Set.setMembers`. Tuples that are not members are ignored.
+
+  :param list columns: The components of the members to remove.
+*/
+void RSetEntity::removeMembers(Rcpp::List columns) {
+  updateMembers(_ampl, _impl.name(), columns, "diff");
+}
+
 // *** RCPP_MODULE ***
 RCPP_MODULE(rset_entity){
   Rcpp::class_<RBasicEntity<ampl::SetInstance, RSetInstance> >("SEntity")
@@ -123,14 +255,22 @@ RCPP_MODULE(rset_entity){
     .const_method("get", &RBasicEntity<ampl::SetInstance, RSetInstance>::getScalar)
     .const_method("find", &RBasicEntity<ampl::SetInstance, RSetInstance>::find)
     .const_method("getInstances", &RBasicEntity<ampl::SetInstance, RSetInstance>::getInstances)
+    .const_method("getInstances", &RBasicEntity<ampl::SetInstance, RSetInstance>::getLazyInstances)
     ;
   Rcpp::class_<RSetEntity>("Set")
     .derives<RBasicEntity<ampl::SetInstance, RSetInstance> >("SEntity")
     .method("arity", &RSetEntity::arity, "The arity of the set")
     .method("size", &RSetEntity::size, "The number of tuples in the set")
     .method("members", &RSetEntity::members, "The members of the set")
+    .method("membersColumns", &RSetEntity::membersColumns, "The members of the set by columns")
+    .method("getAllMembers", &RSetEntity::getAllMembers, "The members of all the instances of the set")
     .method("contains", &RSetEntity::contains, "Check wether this set instance contains the specified tuple")
+    .method("containsMany", &RSetEntity::containsMany, "Check which tuples are members of this set")
     .method("getValues", &RSetEntity::getValues)
+    .method("getValues", &RSetEntity::getCompactValues)
     .method("setValues", &RSetEntity::setValues, "Set values")
+    .method("setMembers", &RSetEntity::setMembers, "Set the members from a list of columns")
+    .method("addMembers", &RSetEntity::addMembers, "Add members from a list of columns")
+    .method("removeMembers", &RSetEntity::removeMembers, "Remove members given as a list of columns")
     ;
 }
@@ -2,6 +2,7 @@
 #define GUARD_RSetEntity_h
 
 #include <string>
+#include <memory>
 #include <vector>
 #include "ampl/entity.h"
 #include "ampl/instance.h"
@@ -12,14 +13,23 @@
 class RSetEntity: public RBasicEntity<ampl::SetInstance, RSetInstance> {
 public:
   ampl::Set _impl;
-  RSetEntity(ampl::Set impl);
+  RSetEntity(ampl::Set impl, ampl::AMPL *ampl = NULL);
   int arity() const;
   int size() const;
-  std::vector<Rcpp::List> members() const;
+  Rcpp::List members() const;
+  Rcpp::List membersColumns() const;
+  Rcpp::DataFrame getAllMembers() const;
   bool contains(Rcpp::List tuple) const;
+  Rcpp::LogicalVector containsMany(Rcpp::DataFrame tuples) const;
   Rcpp::DataFrame getValues() const;
+  Rcpp::DataFrame getCompactValues(bool compact) const;
   void setValues(SEXP values);
   void setValuesList(Rcpp::List values);
+  void setMembers(Rcpp::List columns);
+  void addMembers(Rcpp::List columns);
+  void removeMembers(Rcpp::List columns);
+private:
+  mutable std::shared_ptr<MemberIndex> _index;
 };
 
 RCPP_EXPOSED_CLASS(RSetEntity)
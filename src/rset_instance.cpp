@@ -13,7 +13,7 @@ SetInstance
 
 
 */
-RSetInstance::RSetInstance(ampl::SetInstance impl): _impl(impl) { }
+RSetInstance::RSetInstance(ampl::SetInstance impl, ampl::AMPL *ampl): _impl(impl), _ampl(ampl) { }
 
 /*.. method:: SetInstance.name()
 
@@ -51,13 +51,26 @@ int RSetInstance::size() {
 
   :return: The list of members of the set.
 */
-std::vector<Rcpp::List> RSetInstance::members() {
-  std::vector<Rcpp::List> members;
-  ampl::SetInstance::MemberRange range = _impl.members();
-  for(ampl::SetInstance::MemberRange::iterator it = range.begin(); it != range.end(); it++){
-    members.push_back(tuple2list(*it));
+Rcpp::List RSetInstance::members() {
+  return members2list(_impl.members(), _impl.size());
+}
+
+/*.. method:: SetInstance.membersColumns()
+
+  Get the members of this set by columns, with one vector per component
+  of the tuples, instead of one list per member. It takes much less time
+  and memory than :meth:`~SetInstance.members` for large sets.
+
+  :return: A list with one `numeric` or `character` vector per component.
+*/
+Rcpp::List RSetInstance::membersColumns() {
+  // Only the set has the arity, which an empty instance cannot tell
+  int arity = -1;
+  if(_ampl != NULL) {
+    std::string name = _impl.name();
+    arity = static_cast<int>(_ampl->getSet(name.substr(0, name.find('['))).arity());
   }
-  return members;
+  return members2columns(_impl.members(), _impl.size(), arity);
 }
 
 /*.. method:: SetInstance.contains(tuple)
@@ -70,6 +83,26 @@ bool RSetInstance::contains(Rcpp::List tuple) const {
   return _impl.contains(list2tuple(tuple));
 }
 
+/*.. method:: SetInstance.containsMany(tuples)
+
+  Check which rows of a `data.frame` are members of this set, with one
+  column per component of the set tuples. The members are hashed on the
+  first call and the index is reused until the data in AMPL changes.
+  Rows with an ``NA`` element are not members.
+
+  :param `data.frame` tuples: The tuples to check.
+  :return: A `logical` vector with one element per row of ``tuples``.
+*/
+Rcpp::LogicalVector RSetInstance::containsMany(Rcpp::DataFrame tuples) const {
+  if(!_index || !_index->isCurrent()) {
+    if(!_index) {
+      _index.reset(new MemberIndex());
+    }
+    _index->build(_impl.members());
+  }
+  return _index->contains(tuples);
+}
+
 /*.. method:: SetInstance.getValues()
 
   Get values of this set in a data.frame. Valid only for non indexed sets.
@@ -80,15 +113,38 @@ Rcpp::DataFrame RSetInstance::getValues() const {
   return df2rdf(_impl.getValues());
 }
 
+/*.. method:: SetInstance.getValues(compact)
+
+  Get values of this set in a data.frame, optionally with integral columns
+  as `integer` and the other columns as `factor`, with sorted levels.
+  Valid only for non indexed sets.
+
+  :param logical compact: Whether to use integer and factor columns.
+  :return: `data.frame` containing the values of this set.
+*/
+Rcpp::DataFrame RSetInstance::getCompactValues(bool compact) const {
+  return df2rdf(_impl.getValues(), compact);
+}
+
 /*.. method:: SetInstance.setValues(values)
 
-  Set values. Valid only for non indexed sets.
+  Set values. Valid only for non indexed sets. Integer vectors made of
+  a few runs of consecutive values, such as ``1:1e7``, are sent as ranges
+  (``lo..hi``) without expanding them.
 */
 void RSetInstance::setValues(SEXP values) {
+  dataChanged(_ampl, _impl.name());
   if(::Rf_inherits(values, "data.frame")) {
     Rcpp::DataFrame df = values;
+    if(df.size() == 1 && setMemberRanges(_ampl, _impl.name(), df[0])) {
+      return;
+    }
     df.push_front(Rcpp::Range(1, df.nrows()), "index"); // FIXME: shouldn't be necessary
     _impl.setValues(rdf2df(df));
+  } else if(::Rf_isVectorAtomic(values)) {
+    if(!setMemberRanges(_ampl, _impl.name(), values)) {
+      setMemberColumns(_impl, Rcpp::List::create(values), 1);
+    }
   } else {
     setValuesList(values);
   }
@@ -102,6 +158,43 @@ void RSetInstance::setValuesList(Rcpp::List values) {
   return _impl.setValues(objects.data(), objects.size());
 }
 
+/*.. method:: SetInstance.setMembers(columns)
+
+  Set the members of this set from a list (or `data.frame`) with one
+  vector per component of the tuples, e.g. ``s$setMembers(list(from, to))``.
+  The columns can be `numeric`, `integer`, `character` or `factor`, and are
+  passed to AMPL without building a list per member.
+
+  :param list columns: The components of the members.
+*/
+void RSetInstance::setMembers(Rcpp::List columns) {
+  dataChanged(_ampl, _impl.name());
+  setMemberColumns(_impl, columns, 1);
+}
+
+/*.. method:: SetInstance.addMembers(columns)
+
+  Add members to this set, with the same columns as
+  :meth:`~SetInstance.setMembers`. Only the new members are sent to AMPL, which
+  checks them all at once. Members already in the set are ignored.
+
+  :param list columns: The components of the members to add.
+*/
+void RSetInstance::addMembers(Rcpp::List columns) {
+  updateMembers(_ampl, _impl.name(), columns, "union");
+}
+
+/*.. method:: SetInstance.removeMembers(columns)
+
+  Remove members from this set, with the same columns as
+  :meth:`~SetInstance.setMembers`. Tuples that are not members are ignored.
+
+  :param list columns: The components of the members to remove.
+*/
+void RSetInstance::removeMembers(Rcpp::List columns) {
+  updateMembers(_ampl, _impl.name(), columns, "diff");
+}
+
 // *** RCPP_MODULE ***
 RCPP_MODULE(rset_instance){
   Rcpp::class_<RSetInstance>("SetInstance")
@@ -109,8 +202,14 @@ RCPP_MODULE(rset_instance){
     .method("toString", &RSetInstance::toString)
     .method("size", &RSetInstance::size, "The number of tuples in the set")
     .method("members", &RSetInstance::members, "The members of the set")
+    .method("membersColumns", &RSetInstance::membersColumns, "The members of the set by columns")
     .method("contains", &RSetInstance::contains, "Check wether this set instance contains the specified tuple")
+    .method("containsMany", &RSetInstance::containsMany, "Check which tuples are members of this set")
     .method("getValues", &RSetInstance::getValues, "Get values")
+    .method("getValues", &RSetInstance::getCompactValues, "Get values")
     .method("setValues", &RSetInstance::setValues, "Set values")
+    .method("setMembers", &RSetInstance::setMembers, "Set the members from a list of columns")
+    .method("addMembers", &RSetInstance::addMembers, "Add members from a list of columns")
+    .method("removeMembers", &RSetInstance::removeMembers, "Remove members given as a list of columns")
     ;
 }
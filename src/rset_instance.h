@@ -2,24 +2,40 @@
 #define GUARD_RSetInstance_h
 
 #include <string>
+#include <memory>
 #include "ampl/entity.h"
+#include "utils.h"
 #include <Rcpp.h>
 
 class RSetInstance {
 public:
   ampl::SetInstance _impl;
-  RSetInstance(ampl::SetInstance impl);
+  ampl::AMPL *_ampl;
+  RSetInstance(ampl::SetInstance impl, ampl::AMPL *ampl = NULL);
   std::string name() const;
   std::string toString() const;
   //int arity() const; FIXME: ?
   int size();
-  std::vector<Rcpp::List> members();
+  Rcpp::List members();
+  Rcpp::List membersColumns();
   bool contains(Rcpp::List tuple) const;
+  Rcpp::LogicalVector containsMany(Rcpp::DataFrame tuples) const;
   Rcpp::DataFrame getValues() const;
+  Rcpp::DataFrame getCompactValues(bool compact) const;
   void setValues(SEXP values);
   void setValuesList(Rcpp::List values);
+  void setMembers(Rcpp::List columns);
+  void addMembers(Rcpp::List columns);
+  void removeMembers(Rcpp::List columns);
+private:
+  mutable std::shared_ptr<MemberIndex> _index;
 };
 
 RCPP_EXPOSED_CLASS(RSetInstance)
 
+template <>
+inline RSetInstance wrapInstance<RSetInstance, ampl::SetInstance>(const ampl::SetInstance &instance, ampl::AMPL *ampl) {
+  return RSetInstance(instance, ampl);
+}
+
 #endif
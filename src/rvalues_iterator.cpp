@@ -0,0 +1,99 @@
+#include "rvalues_iterator.h"
+#include "utils.h"
+#include <algorithm>
+#include <Rcpp.h>
+/*.. _secRrefValuesIterator:
+.. highlight:: r
+
+ValuesIterator
+==============
+
+*/
+
+/*.. class:: ValuesIterator
+
+  Iterates over the values of an entity in chunks of a fixed number of
+  rows. Each chunk is returned as a `data.frame` with the same columns as
+  :meth:`~.Entity.getValues`, so large entities can be written out or
+  aggregated without holding the whole table in R at once.
+
+  Objects of this class are obtained with :meth:`~.Entity.valuesIterator`::
+
+    it <- x$valuesIterator(list("val"), 100000)
+    while (it$hasNext()) {
+      chunk <- it$nextChunk()
+      ...
+    }
+*/
+RValuesIterator::RValuesIterator(std::shared_ptr<ampl::DataFrame> impl, int chunkSize):
+  _impl(impl), _position(0), _chunkSize(chunkSize) {
+  if(chunkSize <= 0) {
+    Rcpp::stop("chunkSize must be positive");
+  }
+}
+
+/*.. method:: ValuesIterator.numRows()
+
+  Get the total number of rows.
+
+  :return: The number of rows of the underlying table.
+*/
+int RValuesIterator::numRows() const {
+  return _impl->getNumRows();
+}
+
+/*.. method:: ValuesIterator.chunkSize()
+
+  Get the maximum number of rows in each chunk.
+
+  :return: The chunk size.
+*/
+int RValuesIterator::chunkSize() const {
+  return _chunkSize;
+}
+
+/*.. method:: ValuesIterator.hasNext()
+
+  Check whether there are rows left to be returned.
+
+  :return: ``TRUE`` if :meth:`~.ValuesIterator.nextChunk` returns more rows.
+*/
+bool RValuesIterator::hasNext() const {
+  return _position < _impl->getNumRows();
+}
+
+/*.. method:: ValuesIterator.nextChunk()
+
+  Get the next chunk of rows and advance the iterator.
+
+  :return: A `data.frame` with at most ``chunkSize`` rows.
+  :raises Error: If there are no rows left.
+*/
+Rcpp::DataFrame RValuesIterator::nextChunk() {
+  if(!hasNext()) {
+    Rcpp::stop("no more rows");
+  }
+  std::size_t nrows = std::min(_chunkSize, _impl->getNumRows() - _position);
+  Rcpp::DataFrame chunk = df2rdf(*_impl, false, _position, nrows);
+  _position += nrows;
+  return chunk;
+}
+
+/*.. method:: ValuesIterator.reset()
+
+  Restart the iteration from the first row.
+*/
+void RValuesIterator::reset() {
+  _position = 0;
+}
+
+// *** RCPP_MODULE ***
+RCPP_MODULE(rvalues_iterator){
+  Rcpp::class_<RValuesIterator>("ValuesIterator")
+    .method("numRows", &RValuesIterator::numRows, "Get the total number of rows")
+    .method("chunkSize", &RValuesIterator::chunkSize, "Get the maximum number of rows in each chunk")
+    .method("hasNext", &RValuesIterator::hasNext, "Check whether there are rows left")
+    .method("nextChunk", &RValuesIterator::nextChunk, "Get the next chunk of rows")
+    .method("reset", &RValuesIterator::reset, "Restart the iteration")
+    ;
+}
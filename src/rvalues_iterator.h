@@ -0,0 +1,23 @@
+#ifndef GUARD_RValuesIterator_h
+#define GUARD_RValuesIterator_h
+
+#include <memory>
+#include "ampl/dataframe.h"
+#include <Rcpp.h>
+
+class RValuesIterator {
+public:
+  std::shared_ptr<ampl::DataFrame> _impl;
+  std::size_t _position;
+  std::size_t _chunkSize;
+  RValuesIterator(std::shared_ptr<ampl::DataFrame> impl, int chunkSize);
+  int numRows() const;
+  int chunkSize() const;
+  bool hasNext() const;
+  Rcpp::DataFrame nextChunk();
+  void reset();
+};
+
+RCPP_EXPOSED_CLASS(RValuesIterator)
+
+#endif
@@ -26,7 +26,7 @@ Variable
   :class:`DataFrame` class.
 
 */
-RVariableEntity::RVariableEntity(ampl::Variable impl): RBasicEntity<ampl::VariableInstance, RVariableInstance>(impl), _impl(impl) { }
+RVariableEntity::RVariableEntity(ampl::Variable impl, ampl::AMPL *ampl): RBasicEntity<ampl::VariableInstance, RVariableInstance>(impl, ampl), _impl(impl) { }
 
 /*.. method:: Variable.value()
 
@@ -64,9 +64,11 @@ std::string RVariableEntity::integrality() const {
   :return: ``NULL``.
 */
 void RVariableEntity::fix() {
+  dataChanged(_ampl, _impl.name());
   _impl.fix();
 }
 void RVariableEntity::fixDbl(double value) {
+  dataChanged(_ampl, _impl.name());
   _impl.fix(value);
 }
 
@@ -77,9 +79,113 @@ void RVariableEntity::fixDbl(double value) {
   :return: ``NULL``.
 */
 void RVariableEntity::unfix() {
+  dataChanged(_ampl, _impl.name());
   _impl.unfix();
 }
 
+/*.. method:: Variable.fixSubset(index, values=NULL)
+
+  Fix the instances with the specified indices, to their current values or
+  to the specified values if provided, in a single operation. Each row of
+  ``index`` (a `data.frame` or a list of columns) is the index of one
+  instance. For instance::
+
+    x$fixSubset(data.frame(i = c(1, 2), j = c("a", "b")), c(0, 1))
+
+  is equivalent to ``fix x[1, 'a'] := 0; fix x[2, 'b'] := 1;``.
+
+  :param `data.frame` index: The indices of the instances to fix.
+  :param numeric values: The values to fix them to, one per row of ``index``,
+    or ``NULL`` to fix them to their current values.
+
+  :return: ``NULL``.
+*/
+void RVariableEntity::fixSubset(Rcpp::List index) {
+  if(emptyIndex(index)) {
+    return;
+  }
+  dataChanged(_ampl, _impl.name());
+  TempIndex subset(_ampl, index);
+  _ampl->eval("fix " + subset.indexing() + " " + _impl.name() + subset.subscript() + ";");
+}
+void RVariableEntity::fixSubsetDbl(Rcpp::List index, SEXP values) {
+  if(Rf_isNull(values)) {
+    return fixSubset(index);
+  }
+  if(emptyIndex(index)) {
+    return;
+  }
+  dataChanged(_ampl, _impl.name());
+  TempIndex subset(_ampl, index);
+  std::string param = subset.addParam(values);
+  _ampl->eval("fix " + subset.indexing() + " " + _impl.name() + subset.subscript() +
+    " := " + param + subset.subscript() + ";");
+}
+
+/*.. method:: Variable.unfixSubset(index)
+
+  Unfix the instances with the specified indices in a single operation
+  (see :meth:`~Variable.fixSubset`).
+
+  :param `data.frame` index: The indices of the instances to unfix.
+
+  :return: ``NULL``.
+*/
+void RVariableEntity::unfixSubset(Rcpp::List index) {
+  if(emptyIndex(index)) {
+    return;
+  }
+  dataChanged(_ampl, _impl.name());
+  TempIndex subset(_ampl, index);
+  _ampl->eval("unfix " + subset.indexing() + " " + _impl.name() + subset.subscript() + ";");
+}
+
+/*.. method:: Variable.setBounds(index, lb, ub)
+
+  Set the lower and upper bounds of the instances with the specified
+  indices in a single operation, equivalent to ``let x[...].lb := ...``
+  for each of them. Either bound can be ``NULL`` to leave it unchanged.
+
+  :param `data.frame` index: The indices of the instances.
+  :param numeric lb: The new lower bounds, one per row of ``index``.
+  :param numeric ub: The new upper bounds, one per row of ``index``.
+
+  :return: ``NULL``.
+*/
+void RVariableEntity::setBounds(Rcpp::List index, SEXP lb, SEXP ub) {
+  if(emptyIndex(index) || (Rf_isNull(lb) && Rf_isNull(ub))) {
+    return;
+  }
+  dataChanged(_ampl, _impl.name());
+  TempIndex subset(_ampl, index);
+  std::string statements;
+  if(!Rf_isNull(lb)) {
+    std::string param = subset.addParam(lb);
+    statements += "let " + subset.indexing() + " " + _impl.name() + subset.subscript() +
+      ".lb := " + param + subset.subscript() + ";";
+  }
+  if(!Rf_isNull(ub)) {
+    std::string param = subset.addParam(ub);
+    statements += "let " + subset.indexing() + " " + _impl.name() + subset.subscript() +
+      ".ub := " + param + subset.subscript() + ";";
+  }
+  _ampl->eval(statements);
+}
+
+/*.. method:: Variable.setBoundsVector(lb, ub)
+
+  Set the lower and upper bounds of all instances by position, in the
+  order of :meth:`~.Entity.getIndexFrame` (see :meth:`~Variable.setBounds`).
+
+  :param numeric lb: The new lower bounds, one per instance, or ``NULL``.
+  :param numeric ub: The new upper bounds, one per instance, or ``NULL``.
+
+  :return: ``NULL``.
+*/
+void RVariableEntity::setBoundsVector(SEXP lb, SEXP ub) {
+  setBounds(getIndexFrame(), lb, ub);
+}
+
 // **** SCALAR VARIABLES ****
 
 /*.. method:: Variable.setValue()
@@ -92,6 +198,7 @@ void RVariableEntity::unfix() {
   :return: ``NULL``.
 */
 void RVariableEntity::setValue(double value) {
+  dataChanged(_ampl, _impl.name());
   _impl.setValue(value);
 }
 
@@ -338,12 +445,26 @@ RCPP_MODULE(rvar_entity){
     .const_method("xref", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::xref)
     .const_method("getValues", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getSuffixValues)
     .const_method("getValues", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getValues)
+    .const_method("getValues", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getCompactValues)
     .method("setValues", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::setValues)
     .const_method("[[", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::get)
     .const_method("get", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::get)
     .const_method("get", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getScalar)
     .const_method("find", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::find)
     .const_method("getInstances", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getInstances)
+    .const_method("getInstances", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getLazyInstances)
+    .const_method("valuesIterator", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::valuesIterator)
+    .const_method("getValuesArrow", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getArrowValues)
+    .method("setValuesArrow", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::setArrowValues)
+    .const_method("getArray", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getArray)
+    .const_method("getArray", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getSuffixArray)
+    .method("setArray", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::setArray)
+    .const_method("getSparse", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getSparse)
+    .const_method("getValueVector", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getValueVector)
+    .const_method("getIndexFrame", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getIndexFrame)
+    .method("setValueVector", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::setValueVector)
+    .const_method("getMany", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getMany)
+    .const_method("getMany", &RBasicEntity<ampl::VariableInstance, RVariableInstance>::getSuffixMany)
     ;
   Rcpp::class_<RVariableEntity>("Variable")
     .derives<RBasicEntity<ampl::VariableInstance, RVariableInstance> >("VEntity")
@@ -352,6 +473,11 @@ RCPP_MODULE(rvar_entity){
     .method("fix", &RVariableEntity::fixDbl, "Fix all instances of this variable to the specified value")
     .method("fix", &RVariableEntity::fix, "Fix all instances of this variable to their current value")
     .method("unfix", &RVariableEntity::unfix, "Unfix this variable instances")
+    .method("fixSubset", &RVariableEntity::fixSubset, "Fix the specified instances to their current value")
+    .method("fixSubset", &RVariableEntity::fixSubsetDbl, "Fix the specified instances to the specified values")
+    .method("unfixSubset", &RVariableEntity::unfixSubset, "Unfix the specified instances")
+    .method("setBounds", &RVariableEntity::setBounds, "Set the bounds of the specified instances")
+    .method("setBoundsVector", &RVariableEntity::setBoundsVector, "Set the bounds of all instances by position")
     .method("setValue", &RVariableEntity::setValue, "Set the current value of this variable")
     .method("astatus", &RVariableEntity::astatus, "Get the variable status")
     .method("defeqn", &RVariableEntity::defeqn, "Get the index of the defining constraint")
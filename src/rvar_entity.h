@@ -11,12 +11,17 @@
 class RVariableEntity: public RBasicEntity<ampl::VariableInstance, RVariableInstance> {
 public:
   ampl::Variable _impl;
-  RVariableEntity(ampl::Variable impl);
+  RVariableEntity(ampl::Variable impl, ampl::AMPL *ampl = NULL);
   double value() const;
   std::string integrality() const;
   void fix();
   void fixDbl(double value);
   void unfix();
+  void fixSubset(Rcpp::List index);
+  void fixSubsetDbl(Rcpp::List index, SEXP values);
+  void unfixSubset(Rcpp::List index);
+  void setBounds(Rcpp::List index, SEXP lb, SEXP ub);
+  void setBoundsVector(SEXP lb, SEXP ub);
   void setValue(double value);
   std::string astatus() const;
   int defeqn() const;
@@ -23,7 +23,7 @@ VariableInstance
   All the accessors in this class throw an error if the instance
   has been deleted in the underlying AMPL interpreter.
 */
-RVariableInstance::RVariableInstance(ampl::VariableInstance impl): _impl(impl) { }
+RVariableInstance::RVariableInstance(ampl::VariableInstance impl, ampl::AMPL *ampl): _impl(impl), _ampl(ampl) { }
 
 /*.. method:: VariableInstance.name()
 
@@ -64,9 +64,11 @@ double RVariableInstance::value() const {
   :return: ``NULL``.
 */
 void RVariableInstance::fix() {
+  dataChanged(_ampl, _impl.name());
   _impl.fix();
 }
 void RVariableInstance::fixDbl(double value) {
+  dataChanged(_ampl, _impl.name());
   _impl.fix(value);
 }
 
@@ -77,6 +79,7 @@ void RVariableInstance::fixDbl(double value) {
   :return: ``NULL``.
 */
 void RVariableInstance::unfix() {
+  dataChanged(_ampl, _impl.name());
   _impl.unfix();
 }
 
@@ -92,6 +95,7 @@ void RVariableInstance::unfix() {
   :return: ``NULL``.
 */
 void RVariableInstance::setValue(double value) {
+  dataChanged(_ampl, _impl.name());
   _impl.setValue(value);
 }
 
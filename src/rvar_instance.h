@@ -4,13 +4,15 @@
 #include <string>
 #include "ampl/entity.h"
 #include "ampl/instance.h"
+#include "utils.h"
 #include <Rcpp.h>
 
 
 class RVariableInstance {
 public:
   ampl::VariableInstance _impl;
-  RVariableInstance(ampl::VariableInstance impl);
+  ampl::AMPL *_ampl;
+  RVariableInstance(ampl::VariableInstance impl, ampl::AMPL *ampl = NULL);
   std::string name() const;
   std::string toString() const;
   double value() const;
@@ -44,4 +46,9 @@ public:
 
 RCPP_EXPOSED_CLASS(RVariableInstance)
 
+template <>
+inline RVariableInstance wrapInstance<RVariableInstance, ampl::VariableInstance>(const ampl::VariableInstance &instance, ampl::AMPL *ampl) {
+  return RVariableInstance(instance, ampl);
+}
+
 #endif
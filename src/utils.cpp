@@ -1,4 +1,10 @@
 #include "utils.h"
+#include "resultcache.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <Rcpp.h>
 
 ampl::Tuple list2tuple(Rcpp::List list) {
@@ -35,6 +41,126 @@ Rcpp::List tuple2list(const ampl::TupleRef &tuple) {
   return list;
 }
 
+#if defined(R_VERSION) && R_VERSION >= R_Version(3, 5, 0)
+static R_xlen_t getRegion(SEXP column, R_xlen_t offset, R_xlen_t n, int *buffer) {
+  return INTEGER_GET_REGION(column, offset, n, buffer);
+}
+
+static R_xlen_t getRegion(SEXP column, R_xlen_t offset, R_xlen_t n, double *buffer) {
+  return REAL_GET_REGION(column, offset, n, buffer);
+}
+#endif
+
+// Reads an integer (V = int) or numeric (V = double) vector by regions,
+// calling f(offset, values, n) for each of them, so that ALTREP vectors
+// such as 1:n are not expanded in R memory.
+template <class V, class F>
+static void forRegions(SEXP column, F f) {
+  R_xlen_t size = XLENGTH(column);
+#if defined(R_VERSION) && R_VERSION >= R_Version(3, 5, 0)
+  const R_xlen_t region = 4096;
+  V values[region];
+  for(R_xlen_t offset = 0; offset < size; offset += region) {
+    f(offset, values, getRegion(column, offset, region, values));
+  }
+#else
+  f(0, static_cast<const V *>(DATAPTR(column)), size);
+#endif
+}
+
+const double *dblColumn(SEXP column, std::vector<double> &buffer) {
+  if(TYPEOF(column) == REALSXP) {
+    return REAL(column);
+  }
+  R_xlen_t size = XLENGTH(column);
+  if(static_cast<R_xlen_t>(buffer.size()) < size) {
+    buffer.resize(size);
+  }
+  forRegions<int>(column, [&buffer](R_xlen_t offset, const int *values, R_xlen_t n) {
+    for(R_xlen_t i = 0; i < n; i++) {
+      buffer[offset + i] = values[i] == NA_INTEGER ? NA_REAL : values[i];
+    }
+  });
+  return buffer.data();
+}
+
+bool integerRuns(SEXP column, std::vector<std::pair<int, int> > &runs, std::size_t maxRuns) {
+  runs.clear();
+  bool valid = true;
+  if(TYPEOF(column) == INTSXP && !::Rf_isFactor(column)) {
+    forRegions<int>(column, [&](R_xlen_t, const int *values, R_xlen_t n) {
+      for(R_xlen_t i = 0; i < n && valid; i++) {
+        if(values[i] == NA_INTEGER) {
+          valid = false;
+        } else if(!runs.empty() && runs.back().second != INT_MAX && values[i] == runs.back().second + 1) {
+          runs.back().second = values[i];
+        } else {
+          runs.push_back(std::make_pair(values[i], values[i]));
+          valid = runs.size() <= maxRuns;
+        }
+      }
+    });
+  } else if(TYPEOF(column) == REALSXP) {
+    forRegions<double>(column, [&](R_xlen_t, const double *values, R_xlen_t n) {
+      for(R_xlen_t i = 0; i < n && valid; i++) {
+        double value = values[i];
+        if(!(value > INT_MIN && value < INT_MAX && value == static_cast<int>(value))) {
+          valid = false;
+        } else if(!runs.empty() && static_cast<int>(value) == runs.back().second + 1) {
+          runs.back().second = static_cast<int>(value);
+        } else {
+          runs.push_back(std::make_pair(static_cast<int>(value), static_cast<int>(value)));
+          valid = runs.size() <= maxRuns;
+        }
+      }
+    });
+  } else {
+    valid = false;
+  }
+  return valid;
+}
+
+bool setMemberRanges(ampl::AMPL *ampl, const std::string &name, SEXP column) {
+  // Ranges only pay off if they are much shorter than the members
+  const std::size_t maxRuns = 10000;
+  std::vector<std::pair<int, int> > runs;
+  R_xlen_t size = XLENGTH(column);
+  if(ampl == NULL || size == 0 || !integerRuns(column, runs, maxRuns) ||
+    static_cast<R_xlen_t>(runs.size()) * 4 > size) {
+    return false;
+  }
+  std::string statement = "let " + name + " := ";
+  for(std::size_t i = 0; i < runs.size(); i++) {
+    if(i > 0) {
+      statement += " union ";
+    }
+    statement += std::to_string(runs[i].first) + ".." + std::to_string(runs[i].second);
+  }
+  dataChanged(ampl, name);
+  ampl->eval(statement + ";");
+  return true;
+}
+
+const char **strColumn(SEXP column, std::vector<const char *> &buffer) {
+  R_xlen_t size = XLENGTH(column);
+  buffer.resize(size);
+  if(::Rf_isFactor(column)) {
+    SEXP levels = Rf_getAttrib(column, R_LevelsSymbol);
+    const int *codes = INTEGER(column);
+    for(R_xlen_t i = 0; i < size; i++) {
+      if(codes[i] == NA_INTEGER) {
+        Rcpp::stop("missing values are not supported in factor columns");
+      }
+      buffer[i] = CHAR(STRING_ELT(levels, codes[i] - 1));
+    }
+  } else {
+    for(R_xlen_t i = 0; i < size; i++) {
+      buffer[i] = CHAR(STRING_ELT(column, i));
+    }
+  }
+  return buffer.data();
+}
+
 ampl::DataFrame rdf2df(Rcpp::DataFrame rdf, int numberOfIndexColumns){
   int nrows = rdf.nrows();
   int ncols = rdf.length();
@@ -47,74 +173,913 @@ ampl::DataFrame rdf2df(Rcpp::DataFrame rdf, int numberOfIndexColumns){
     numberOfIndexColumns = ncols - 1;
   }
   ampl::DataFrame df(numberOfIndexColumns, ampl::StringArgs(names, ncols));
-  int p = 0;
-  for(Rcpp::DataFrame::iterator it = rdf.begin(); it != rdf.end(); it++){
-    switch(TYPEOF(*it)) {
+  setColumns(df, rdf, names, nrows);
+  return df;
+}
+
+void setColumns(ampl::DataFrame &df, Rcpp::List columns, const char *const *names, std::size_t nrows){
+  // Numeric columns are passed straight from R memory; integer and string
+  // columns go through scratch buffers shared by all columns of this call.
+  std::vector<double> dbl_buffer;
+  std::vector<const char *> str_buffer;
+  for(int p = 0; p < columns.size(); p++){
+    SEXP column = columns[p];
+    switch(TYPEOF(column)) {
       case REALSXP:
-        df.setColumn(names[p++], Rcpp::as<std::vector<double> >(*it).data(), nrows);
+        df.setColumn(names[p], REAL(column), nrows);
         break;
       case INTSXP:
-        if(::Rf_isFactor(*it) == false) {
-          Rcpp::IntegerVector iv = *it;
-          std::vector<double> dbl_column(iv.size());
-          for(int i = 0; i < iv.size(); i++) {
-            dbl_column[i] = iv[i];
-          }
-          df.setColumn(names[p++], dbl_column.data(), dbl_column.size());
-        } else{
-          Rcpp::IntegerVector iv = *it;
-          std::vector<const char *> str_column(iv.size());
-          std::vector<std::string > levels = Rcpp::as<std::vector<std::string> >(iv.attr("levels"));
-          for(int i = 0; i < iv.size(); i++) {
-            str_column[i] = levels[iv[i]-1].c_str();
-          }
-          df.setColumn(names[p++], str_column.data(), str_column.size());
+        if(::Rf_isFactor(column) == false) {
+          df.setColumn(names[p], dblColumn(column, dbl_buffer), nrows);
+        } else {
+          df.setColumn(names[p], strColumn(column, str_buffer), nrows);
         }
         break;
-      case STRSXP: {
-          Rcpp::StringVector iv = *it;
-          std::vector<const char *> str_column(iv.size());
-          for(int i = 0; i < iv.size(); i++) {
-            str_column[i] = iv[i];
-          }
-          df.setColumn(names[p++], str_column.data(), str_column.size());
-        }
+      case STRSXP:
+        df.setColumn(names[p], strColumn(column, str_buffer), nrows);
         break;
       default:
         Rcpp::stop("invalid type");
     }
   }
-  return df;
 }
 
-Rcpp::DataFrame df2rdf(const ampl::DataFrame &df){
-  Rcpp::List tmp;
+std::string dbl2str(double value) {
+  if(ISNA(value)) {
+    return "NA";
+  } else if(ISNAN(value)) {
+    return "NaN";
+  } else if(!R_FINITE(value)) {
+    return value > 0 ? "Inf" : "-Inf";
+  }
+  // Shortest representation that reads back as the same double
+  char buffer[32];
+  for(int precision = 15; precision <= 17; precision++) {
+    snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+    if(std::strtod(buffer, NULL) == value) {
+      break;
+    }
+  }
+  return buffer;
+}
+
+ColumnBuilder::ColumnBuilder(R_xlen_t size, bool integers, bool factors):
+  _size(size), _integers(integers), _factors(factors), _numeric(true), _integral(true),
+  _dbl(Rcpp::no_init(size)) { }
+
+void ColumnBuilder::set(R_xlen_t i, const ampl::VariantRef &value) {
+  if(_numeric) {
+    if(value.type() == ampl::NUMERIC) {
+      double dbl = value.dbl();
+      _dbl[i] = dbl;
+      if(_integral && _integers) {
+        _integral = dbl > INT_MIN && dbl <= INT_MAX && dbl == static_cast<int>(dbl);
+      }
+      return;
+    } else if(value.type() != ampl::STRING) {
+      _dbl[i] = NA_REAL;
+      return;
+    }
+    promote(i);
+  }
+  if(value.type() == ampl::STRING) {
+    setLabel(i, value.c_str());
+  } else if(value.type() == ampl::NUMERIC) {
+    setLabel(i, dbl2str(value.dbl()).c_str());
+  } else if(_factors) {
+    _codes[i] = NA_INTEGER;
+  } else {
+    SET_STRING_ELT(_str, i, NA_STRING);
+  }
+}
+
+void ColumnBuilder::setLabel(R_xlen_t i, const char *label) {
+  if(_factors) {
+    std::pair<std::unordered_map<std::string, int>::iterator, bool> entry =
+      _levels.insert(std::make_pair(std::string(label), static_cast<int>(_levels.size()) + 1));
+    _codes[i] = entry.first->second;
+  } else {
+    SET_STRING_ELT(_str, i, Rf_mkChar(label));
+  }
+}
+
+void ColumnBuilder::promote(R_xlen_t filled) {
+  if(_factors) {
+    _codes = Rcpp::IntegerVector(Rcpp::no_init(_size));
+  } else {
+    _str = Rcpp::CharacterVector(_size);
+  }
+  _numeric = false;
+  for(R_xlen_t i = 0; i < filled; i++) {
+    if(ISNA(_dbl[i])) {
+      if(_factors) {
+        _codes[i] = NA_INTEGER;
+      } else {
+        SET_STRING_ELT(_str, i, NA_STRING);
+      }
+    } else {
+      setLabel(i, dbl2str(_dbl[i]).c_str());
+    }
+  }
+  _dbl = Rcpp::NumericVector(0);
+}
+
+void ColumnBuilder::setNA(R_xlen_t i) {
+  if(_numeric) {
+    _dbl[i] = NA_REAL;
+  } else if(_factors) {
+    _codes[i] = NA_INTEGER;
+  } else {
+    SET_STRING_ELT(_str, i, NA_STRING);
+  }
+}
+
+SEXP ColumnBuilder::get() {
+  if(_numeric) {
+    if(_integers && _integral) {
+      Rcpp::IntegerVector ints(Rcpp::no_init(_size));
+      for(R_xlen_t i = 0; i < _size; i++) {
+        ints[i] = ISNA(_dbl[i]) ? NA_INTEGER : static_cast<int>(_dbl[i]);
+      }
+      return ints;
+    }
+    return _dbl;
+  } else if(_factors) {
+    // Codes follow the first appearance of each label, levels are sorted
+    std::vector<std::pair<std::string, int> > sorted(_levels.begin(), _levels.end());
+    std::sort(sorted.begin(), sorted.end());
+    Rcpp::CharacterVector levels(sorted.size());
+    std::vector<int> recode(sorted.size() + 1);
+    for(std::size_t i = 0; i < sorted.size(); i++) {
+      levels[i] = sorted[i].first;
+      recode[sorted[i].second] = static_cast<int>(i) + 1;
+    }
+    for(R_xlen_t i = 0; i < _size; i++) {
+      if(_codes[i] != NA_INTEGER) {
+        _codes[i] = recode[_codes[i]];
+      }
+    }
+    _codes.attr("levels") = levels;
+    _codes.attr("class") = "factor";
+    return _codes;
+  } else {
+    return _str;
+  }
+}
+
+Rcpp::DataFrame makeDataFrame(Rcpp::List columns, Rcpp::CharacterVector names, R_xlen_t nrows) {
+  columns.attr("names") = names;
+  columns.attr("row.names") = Rcpp::IntegerVector::create(NA_INTEGER, -static_cast<int>(nrows));
+  columns.attr("class") = "data.frame";
+  return Rcpp::DataFrame(columns);
+}
+
+Rcpp::DataFrame df2rdf(const ampl::DataFrame &df, bool compact){
+  return df2rdf(df, compact, 0, df.getNumRows());
+}
+
+Rcpp::DataFrame df2rdf(const ampl::DataFrame &df, bool compact, std::size_t offset, std::size_t nrows){
   int ncols = df.getNumCols();
+  int nindices = df.getNumIndices();
   ampl::StringArray headers = df.getHeaders();
+  Rcpp::List columns(ncols);
+  Rcpp::CharacterVector names(ncols);
   for(int i = 0; i < ncols; i++){
     ampl::DataFrame::Column col = df.getColumn(headers[i]);
-    bool numeric = true;
-    for(ampl::DataFrame::Column::iterator it = col.begin(); it != col.end(); it++){
-      if(it->type() != ampl::NUMERIC) {
-        numeric = false;
-        break;
+    bool index = compact && i < nindices;
+    ColumnBuilder builder(nrows, index, index);
+    for(std::size_t row = 0; row < nrows; row++){
+      builder.set(row, col[offset + row]);
+    }
+    columns[i] = builder.get();
+    names[i] = headers[i];
+  }
+  return makeDataFrame(columns, names, nrows);
+}
+
+Rcpp::DataFrame df2indexframe(const ampl::DataFrame &df) {
+  std::size_t nrows = df.getNumRows();
+  int nindices = df.getNumIndices();
+  ampl::StringArray headers = df.getHeaders();
+  Rcpp::List columns(nindices);
+  Rcpp::CharacterVector names(nindices);
+  for(int i = 0; i < nindices; i++) {
+    ampl::DataFrame::Column col = df.getColumn(headers[i]);
+    ColumnBuilder builder(nrows);
+    for(std::size_t row = 0; row < nrows; row++) {
+      builder.set(row, col[row]);
+    }
+    columns[i] = builder.get();
+    names[i] = headers[i];
+  }
+  return makeDataFrame(columns, names, nrows);
+}
+
+SEXP df2valuevector(const ampl::DataFrame &df) {
+  std::size_t nrows = df.getNumRows();
+  ampl::StringArray headers = df.getHeaders();
+  if(df.getNumCols() != df.getNumIndices() + 1) {
+    Rcpp::stop("expected exactly one value column");
+  }
+  ampl::DataFrame::Column col = df.getColumn(headers[df.getNumIndices()]);
+  ColumnBuilder builder(nrows);
+  for(std::size_t row = 0; row < nrows; row++) {
+    builder.set(row, col[row]);
+  }
+  return builder.get();
+}
+
+void appendKey(std::string &key, double value) {
+  value += 0.0;  // -0 and 0 are the same index
+  key.push_back('n');
+  key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void appendKey(std::string &key, const char *value) {
+  key.push_back('s');
+  key.append(value);
+  key.push_back('\0');
+}
+
+void appendKey(std::string &key, const ampl::VariantRef &value) {
+  if(value.type() == ampl::NUMERIC) {
+    appendKey(key, value.dbl());
+  } else {
+    appendKey(key, value.c_str());
+  }
+}
+
+bool appendKey(std::string &key, SEXP column, R_xlen_t i) {
+  switch(TYPEOF(column)) {
+    case REALSXP:
+      if(ISNAN(REAL(column)[i])) {
+        return false;
+      }
+      appendKey(key, REAL(column)[i]);
+      break;
+    case INTSXP: {
+      int value = INTEGER(column)[i];
+      if(value == NA_INTEGER) {
+        return false;
+      }
+      if(::Rf_isFactor(column)) {
+        appendKey(key, CHAR(STRING_ELT(Rf_getAttrib(column, R_LevelsSymbol), value - 1)));
+      } else {
+        appendKey(key, static_cast<double>(value));
       }
+      break;
     }
-    if(numeric) {
-      std::vector<double> dbl_column;
-      for(ampl::DataFrame::Column::iterator it = col.begin(); it != col.end(); it++){
-        dbl_column.push_back(it->dbl());
+    case STRSXP:
+      if(STRING_ELT(column, i) == NA_STRING) {
+        return false;
+      }
+      appendKey(key, CHAR(STRING_ELT(column, i)));
+      break;
+    default:
+      Rcpp::stop("invalid type");
+  }
+  return true;
+}
+
+int IndexLabels::position(const ampl::VariantRef &value) {
+  std::string key;
+  appendKey(key, value);
+  std::pair<std::unordered_map<std::string, int>::iterator, bool> entry =
+    _positions.insert(std::make_pair(key, static_cast<int>(_labels.size())));
+  if(entry.second) {
+    bool numeric = value.type() == ampl::NUMERIC;
+    _labels.push_back(numeric ? dbl2str(value.dbl()) : std::string(value.c_str()));
+    _numbers.push_back(numeric ? value.dbl() : NA_REAL);
+    _numeric.push_back(numeric);
+    _byLabel.insert(std::make_pair(_labels.back(), entry.first->second));
+  }
+  return entry.first->second;
+}
+
+int IndexLabels::find(const char *label) const {
+  std::unordered_map<std::string, int>::const_iterator it = _byLabel.find(label);
+  if(it != _byLabel.end()) {
+    return it->second;
+  }
+  // Numeric members may be written differently, e.g. "1e+05" by R
+  char *end;
+  double value = std::strtod(label, &end);
+  if(*label == '\0' || *end != '\0') {
+    return -1;
+  }
+  std::string key;
+  appendKey(key, value);
+  it = _positions.find(key);
+  return it == _positions.end() ? -1 : it->second;
+}
+
+const std::string &IndexLabels::label(int position) const {
+  return _labels[position];
+}
+
+bool IndexLabels::isNumeric(int position) const {
+  return _numeric[position];
+}
+
+double IndexLabels::number(int position) const {
+  return _numbers[position];
+}
+
+int IndexLabels::size() const {
+  return _labels.size();
+}
+
+Rcpp::CharacterVector IndexLabels::labels() const {
+  return Rcpp::wrap(_labels);
+}
+
+// Labels of every dimension of an entity, in the order of the members of
+// its indexing sets. Empty if they cannot be told apart by dimension, e.g.
+// for a set of pairs, in which case the order of first appearance is used.
+std::vector<IndexLabels> indexingLabels(ampl::AMPL *ampl, const ampl::Entity &entity) {
+  std::vector<IndexLabels> labels;
+  if(ampl == NULL) {
+    return labels;
+  }
+  ampl::StringArray sets = entity.getIndexingSets();
+  if(static_cast<int>(sets.size()) != entity.indexarity()) {
+    return labels;
+  }
+  labels.resize(sets.size());
+  try {
+    for(std::size_t d = 0; d < sets.size(); d++) {
+      const char *expr = sets[d];
+      ampl::DataFrame members = ampl->getData(ampl::StringArgs(&expr, 1));
+      if(members.getNumCols() != 1) {
+        return std::vector<IndexLabels>();
+      }
+      ampl::DataFrame::Column column = members.getColumn(members.getHeaders()[0]);
+      for(std::size_t row = 0; row < members.getNumRows(); row++) {
+        labels[d].position(column[row]);
+      }
+    }
+  } catch(std::exception &) {
+    return std::vector<IndexLabels>();
+  }
+  return labels;
+}
+
+// Members of every dimension of an entity, to turn labels back into AMPL
+// values: those of its indexing sets or, if they cannot be told apart by
+// dimension, the indices of its instances.
+std::vector<IndexLabels> memberLabels(ampl::AMPL *ampl, const ampl::Entity &entity) {
+  std::vector<IndexLabels> labels = indexingLabels(ampl, entity);
+  if(!labels.empty() || entity.indexarity() == 0) {
+    return labels;
+  }
+  ampl::DataFrame df = entity.getValues();
+  ampl::StringArray headers = df.getHeaders();
+  labels.resize(df.getNumIndices());
+  for(std::size_t d = 0; d < labels.size(); d++) {
+    ampl::DataFrame::Column column = df.getColumn(headers[d]);
+    for(std::size_t row = 0; row < df.getNumRows(); row++) {
+      labels[d].position(column[row]);
+    }
+  }
+  return labels;
+}
+
+SEXP df2array(const ampl::DataFrame &df, std::vector<IndexLabels> labels) {
+  std::size_t nrows = df.getNumRows();
+  int nindices = df.getNumIndices();
+  ampl::StringArray headers = df.getHeaders();
+  if(static_cast<int>(df.getNumCols()) != nindices + 1) {
+    Rcpp::stop("expected exactly one value column");
+  }
+  ColumnBuilder builder(nrows);
+  ampl::DataFrame::Column values = df.getColumn(headers[nindices]);
+  for(std::size_t row = 0; row < nrows; row++) {
+    builder.set(row, values[row]);
+  }
+  SEXP column = builder.get();
+  if(nindices == 0) {
+    return column;
+  }
+  // Map every row to its cell in column-major order
+  labels.resize(nindices);
+  std::vector<R_xlen_t> cells(nrows, 0);
+  R_xlen_t stride = 1;
+  for(int d = 0; d < nindices; d++) {
+    ampl::DataFrame::Column col = df.getColumn(headers[d]);
+    for(std::size_t row = 0; row < nrows; row++) {
+      cells[row] += stride * labels[d].position(col[row]);
+    }
+    stride *= labels[d].size();
+  }
+  Rcpp::IntegerVector dim(nindices);
+  Rcpp::List dimnames(nindices);
+  Rcpp::CharacterVector names(nindices);
+  for(int d = 0; d < nindices; d++) {
+    dim[d] = labels[d].size();
+    dimnames[d] = labels[d].labels();
+    names[d] = headers[d];
+  }
+  dimnames.attr("names") = names;
+  Rcpp::RObject array;
+  if(TYPEOF(column) == REALSXP) {
+    Rcpp::NumericVector from(column);
+    Rcpp::NumericVector to(stride, NA_REAL);
+    for(std::size_t row = 0; row < nrows; row++) {
+      to[cells[row]] = from[row];
+    }
+    array = to;
+  } else {
+    Rcpp::CharacterVector from(column);
+    Rcpp::CharacterVector to(stride, NA_STRING);
+    for(std::size_t row = 0; row < nrows; row++) {
+      SET_STRING_ELT(to, cells[row], STRING_ELT(from, row));
+    }
+    array = to;
+  }
+  array.attr("dim") = dim;
+  array.attr("dimnames") = dimnames;
+  return array;
+}
+
+// Checks that dimnames, if set, has one vector of labels per dimension
+static void checkDimnames(SEXP dimnames, int ndims) {
+  if(Rf_isNull(dimnames)) {
+    return;
+  }
+  if(TYPEOF(dimnames) != VECSXP || XLENGTH(dimnames) != ndims) {
+    Rcpp::stop("expected dimnames with %d elements", ndims);
+  }
+  for(int d = 0; d < ndims; d++) {
+    SEXP labels = VECTOR_ELT(dimnames, d);
+    if(!Rf_isNull(labels) && TYPEOF(labels) != STRSXP) {
+      Rcpp::stop("dimnames must be character vectors");
+    }
+  }
+}
+
+// Header of the index column for dimension d, from names(dimnames) if set
+static std::string dimHeader(SEXP dimnames, int d) {
+  SEXP names = Rf_isNull(dimnames) ? R_NilValue : Rf_getAttrib(dimnames, R_NamesSymbol);
+  if(!Rf_isNull(names) && std::strlen(CHAR(STRING_ELT(names, d))) > 0) {
+    return CHAR(STRING_ELT(names, d));
+  }
+  return "index" + std::to_string(d);
+}
+
+// Sets an index column from dimension labels and 0-based positions. Each
+// label is sent as the member of the indexing set it names, with its type,
+// and without labels the position is that of the member in the set.
+static void setLabelColumn(ampl::DataFrame &df, const char *header, SEXP labels,
+  const std::vector<int> &positions, const IndexLabels &members) {
+  std::size_t nrows = positions.size();
+  R_xlen_t nlabels = Rf_isNull(labels) ? members.size() : XLENGTH(labels);
+  for(std::size_t row = 0; row < nrows; row++) {
+    if(positions[row] < 0 || positions[row] >= nlabels) {
+      Rcpp::stop("index %d out of bounds in dimension '%s'", positions[row] + 1, header);
+    }
+  }
+  std::vector<int> member(nlabels);
+  int numeric = 0;
+  for(R_xlen_t i = 0; i < nlabels; i++) {
+    if(Rf_isNull(labels)) {
+      member[i] = static_cast<int>(i);
+    } else if(STRING_ELT(labels, i) == NA_STRING) {
+      Rcpp::stop("dimnames must not be NA");
+    } else if((member[i] = members.find(CHAR(STRING_ELT(labels, i)))) < 0) {
+      Rcpp::stop("'%s' is not a member of dimension '%s'", CHAR(STRING_ELT(labels, i)), header);
+    }
+    numeric += members.isNumeric(member[i]);
+  }
+  if(numeric > 0 && numeric < nlabels) {
+    Rcpp::stop("dimension '%s' mixes numeric and string members", header);
+  }
+  if(numeric > 0) {
+    std::vector<double> column(nrows);
+    for(std::size_t row = 0; row < nrows; row++) {
+      column[row] = members.number(member[positions[row]]);
+    }
+    df.setColumn(header, column.data(), nrows);
+  } else {
+    std::vector<const char *> column(nrows);
+    for(std::size_t row = 0; row < nrows; row++) {
+      column[row] = members.label(member[positions[row]]).c_str();
+    }
+    df.setColumn(header, column.data(), nrows);
+  }
+}
+
+// Checks that there are the members of one indexing set per dimension
+static void checkMembers(const std::vector<IndexLabels> &members, int ndims) {
+  if(static_cast<int>(members.size()) != ndims) {
+    Rcpp::stop("expected %d dimensions", static_cast<int>(members.size()));
+  }
+}
+
+ampl::DataFrame array2df(SEXP array, const std::string &valueHeader, const std::vector<IndexLabels> &members) {
+  Rcpp::RObject obj(array);
+  if(!obj.hasAttribute("dim")) {
+    Rcpp::stop("expected an array");
+  }
+  Rcpp::IntegerVector dim = obj.attr("dim");
+  SEXP dimnames = Rf_getAttrib(array, R_DimNamesSymbol);
+  int ndims = dim.size();
+  R_xlen_t total = XLENGTH(array);
+  std::vector<R_xlen_t> cells;
+  for(R_xlen_t cell = 0; cell < total; cell++) {
+    bool missing = false;
+    switch(TYPEOF(array)) {
+      case REALSXP: missing = ISNA(REAL(array)[cell]); break;
+      case INTSXP: missing = INTEGER(array)[cell] == NA_INTEGER; break;
+      case STRSXP: missing = STRING_ELT(array, cell) == NA_STRING; break;
+      default: Rcpp::stop("invalid type");
+    }
+    if(!missing) {
+      cells.push_back(cell);
+    }
+  }
+  checkDimnames(dimnames, ndims);
+  checkMembers(members, ndims);
+  std::size_t nrows = cells.size();
+  std::vector<std::string> headers(ndims + 1);
+  std::vector<const char *> names(ndims + 1);
+  for(int d = 0; d < ndims; d++) {
+    headers[d] = dimHeader(dimnames, d);
+  }
+  headers[ndims] = valueHeader;
+  for(int d = 0; d <= ndims; d++) {
+    names[d] = headers[d].c_str();
+  }
+  ampl::DataFrame df(ndims, ampl::StringArgs(names.data(), names.size()));
+  std::vector<int> positions(nrows);
+  R_xlen_t stride = 1;
+  for(int d = 0; d < ndims; d++) {
+    for(std::size_t row = 0; row < nrows; row++) {
+      positions[row] = (cells[row] / stride) % dim[d];
+    }
+    setLabelColumn(df, names[d], Rf_isNull(dimnames) ? R_NilValue : VECTOR_ELT(dimnames, d), positions, members[d]);
+    stride *= dim[d];
+  }
+  if(TYPEOF(array) == STRSXP) {
+    std::vector<const char *> column(nrows);
+    for(std::size_t row = 0; row < nrows; row++) {
+      column[row] = CHAR(STRING_ELT(array, cells[row]));
+    }
+    df.setColumn(names[ndims], column.data(), nrows);
+  } else {
+    std::vector<double> column(nrows);
+    for(std::size_t row = 0; row < nrows; row++) {
+      column[row] = TYPEOF(array) == REALSXP ? REAL(array)[cells[row]] : INTEGER(array)[cells[row]];
+    }
+    df.setColumn(names[ndims], column.data(), nrows);
+  }
+  return df;
+}
+
+Rcpp::List df2sparse(const ampl::DataFrame &df, double eps, std::vector<IndexLabels> labels) {
+  std::size_t nrows = df.getNumRows();
+  ampl::StringArray headers = df.getHeaders();
+  if(df.getNumIndices() != 2 || df.getNumCols() != 3) {
+    Rcpp::stop("expected an entity indexed over two sets and one value column");
+  }
+  ampl::DataFrame::Column rows = df.getColumn(headers[0]);
+  ampl::DataFrame::Column cols = df.getColumn(headers[1]);
+  ampl::DataFrame::Column values = df.getColumn(headers[2]);
+  labels.resize(2);
+  IndexLabels &rowLabels = labels[0];
+  IndexLabels &colLabels = labels[1];
+  std::vector<int> i, j;
+  std::vector<double> x;
+  for(std::size_t row = 0; row < nrows; row++) {
+    // Every index is labelled, so that the dimensions do not depend on eps
+    int r = rowLabels.position(rows[row]);
+    int c = colLabels.position(cols[row]);
+    ampl::VariantRef value = values[row];
+    if(value.type() == ampl::STRING) {
+      Rcpp::stop("sparse matrices only hold numeric values");
+    } else if(value.type() != ampl::NUMERIC) {
+      continue;
+    }
+    if(std::fabs(value.dbl()) > eps) {
+      i.push_back(r + 1);
+      j.push_back(c + 1);
+      x.push_back(value.dbl());
+    }
+  }
+  Rcpp::List dimnames = Rcpp::List::create(
+    Rcpp::Named(headers[0]) = rowLabels.labels(),
+    Rcpp::Named(headers[1]) = colLabels.labels());
+  return Rcpp::List::create(
+    Rcpp::Named("i") = Rcpp::wrap(i),
+    Rcpp::Named("j") = Rcpp::wrap(j),
+    Rcpp::Named("x") = Rcpp::wrap(x),
+    Rcpp::Named("dims") = Rcpp::IntegerVector::create(rowLabels.size(), colLabels.size()),
+    Rcpp::Named("dimnames") = dimnames);
+}
+
+ampl::DataFrame sparse2df(SEXP matrix, const std::string &valueHeader, const std::vector<IndexLabels> &members) {
+  std::vector<int> rows, cols;
+  Rcpp::NumericVector x;
+  SEXP dimnames;
+  if(Rf_isS4(matrix)) {
+    Rcpp::S4 m(matrix);
+    Rcpp::IntegerVector i = m.slot("i");
+    x = m.slot("x");
+    dimnames = m.slot("Dimnames");
+    rows.assign(i.begin(), i.end());
+    if(m.is("dgTMatrix")) {
+      Rcpp::IntegerVector j = m.slot("j");
+      cols.assign(j.begin(), j.end());
+    } else if(m.is("dgCMatrix")) {
+      Rcpp::IntegerVector p = m.slot("p");
+      cols.resize(i.size());
+      for(int c = 0; c + 1 < p.size(); c++) {
+        for(int k = p[c]; k < p[c + 1]; k++) {
+          cols[k] = c;
+        }
       }
-      tmp[headers[i]] = dbl_column;
     } else {
-      std::vector<std::string> str_column;
-      for(ampl::DataFrame::Column::iterator it = col.begin(); it != col.end(); it++){
-        str_column.push_back(it->str());
+      Rcpp::stop("expected a dgTMatrix or a dgCMatrix");
+    }
+  } else {
+    Rcpp::List triplet(matrix);
+    Rcpp::IntegerVector i = triplet["i"];
+    Rcpp::IntegerVector j = triplet["j"];
+    x = triplet["x"];
+    dimnames = triplet.containsElementNamed("dimnames") ? SEXP(triplet["dimnames"]) : R_NilValue;
+    rows.resize(i.size());
+    cols.resize(j.size());
+    for(int k = 0; k < i.size(); k++) {
+      rows[k] = i[k] - 1;
+      cols[k] = j[k] - 1;
+    }
+  }
+  if(rows.size() != cols.size() || static_cast<R_xlen_t>(rows.size()) != x.size()) {
+    Rcpp::stop("i, j and x must have the same length");
+  }
+  checkDimnames(dimnames, 2);
+  checkMembers(members, 2);
+  std::string headers[3] = {dimHeader(dimnames, 0), dimHeader(dimnames, 1), valueHeader};
+  const char *names[3] = {headers[0].c_str(), headers[1].c_str(), headers[2].c_str()};
+  ampl::DataFrame df(2, ampl::StringArgs(names, 3));
+  setLabelColumn(df, names[0], Rf_isNull(dimnames) ? R_NilValue : VECTOR_ELT(dimnames, 0), rows, members[0]);
+  setLabelColumn(df, names[1], Rf_isNull(dimnames) ? R_NilValue : VECTOR_ELT(dimnames, 1), cols, members[1]);
+  df.setColumn(names[2], REAL(x), x.size());
+  return df;
+}
+
+Rcpp::List members2columns(ampl::SetInstance::MemberRange members, std::size_t size, int arity) {
+  std::vector<ColumnBuilder> builders;
+  // One builder each: copies would share the same vector
+  for(int i = 0; i < arity; i++) {
+    builders.push_back(ColumnBuilder(size));
+  }
+  std::size_t row = 0;
+  for(ampl::SetInstance::MemberRange::iterator it = members.begin(); it != members.end(); it++, row++) {
+    ampl::TupleRef tuple = *it;
+    if(builders.empty()) {
+      for(std::size_t i = 0; i < tuple.size(); i++) {
+        builders.push_back(ColumnBuilder(size));
       }
-      tmp[headers[i]] = str_column;
     }
+    for(std::size_t i = 0; i < tuple.size(); i++) {
+      builders[i].set(row, tuple[i]);
+    }
+  }
+  Rcpp::List columns(builders.size());
+  for(std::size_t i = 0; i < builders.size(); i++) {
+    columns[i] = builders[i].get();
+  }
+  return columns;
+}
+
+Rcpp::List members2list(ampl::SetInstance::MemberRange members, std::size_t size) {
+  Rcpp::List list(size);
+  R_xlen_t row = 0;
+  for(ampl::SetInstance::MemberRange::iterator it = members.begin(); it != members.end(); it++, row++) {
+    list[row] = tuple2list(*it);
+  }
+  return list;
+}
+
+SEXP lookupValues(const ampl::DataFrame &df, Rcpp::DataFrame index) {
+  std::size_t nrows = df.getNumRows();
+  int nindices = df.getNumIndices();
+  ampl::StringArray headers = df.getHeaders();
+  if(static_cast<int>(df.getNumCols()) != nindices + 1) {
+    Rcpp::stop("expected exactly one value column");
+  }
+  if(index.size() != nindices) {
+    Rcpp::stop("expected %d index columns", nindices);
+  }
+  std::vector<ampl::DataFrame::Column> columns;
+  for(int i = 0; i <= nindices; i++) {
+    columns.push_back(df.getColumn(headers[i]));
+  }
+  std::unordered_map<std::string, std::size_t> rows(nrows);
+  std::string key;
+  for(std::size_t row = 0; row < nrows; row++) {
+    key.clear();
+    for(int i = 0; i < nindices; i++) {
+      appendKey(key, columns[i][row]);
+    }
+    rows.insert(std::make_pair(key, row));
+  }
+  R_xlen_t n = index.nrows();
+  ColumnBuilder builder(n);
+  for(R_xlen_t i = 0; i < n; i++) {
+    key.clear();
+    bool complete = true;
+    for(int j = 0; j < nindices && complete; j++) {
+      complete = appendKey(key, index[j], i);
+    }
+    std::unordered_map<std::string, std::size_t>::const_iterator it = complete ? rows.find(key) : rows.end();
+    if(it != rows.end()) {
+      builder.set(i, columns[nindices][it->second]);
+    } else {
+      builder.setNA(i);
+    }
+  }
+  return builder.get();
+}
+
+static unsigned long data_version = 0;
+
+unsigned long dataVersion() {
+  return data_version;
+}
+
+void dataChanged(ampl::AMPL *ampl, const std::string &entity) {
+  invalidateResults(ampl, entity);
+  data_version++;
+}
+
+Rcpp::Environment lazyEnvironment(Rcpp::CharacterVector names, Rcpp::InternalFunction load) {
+  Rcpp::Environment env = Rcpp::new_env(R_EmptyEnv, names.size() > 29 ? names.size() : 29);
+  Rcpp::Function delayedAssign("delayedAssign");
+  for(R_xlen_t i = 0; i < names.size(); i++) {
+    // The call is passed as the value expression, so it is only evaluated
+    // when the promise is forced
+    Rcpp::Shield<SEXP> name(Rf_ScalarString(STRING_ELT(names, i)));
+    Rcpp::Shield<SEXP> call(Rf_lang2(load, Rf_ScalarInteger(static_cast<int>(i + 1))));
+    delayedAssign(name, call, R_BaseEnv, env);
+  }
+  return env;
+}
+
+TempEntity::TempEntity(ampl::AMPL *ampl, const std::string &kind, const std::string &declaration): _ampl(ampl) {
+  static unsigned long counter = 0;
+  if(_ampl == NULL) {
+    Rcpp::stop("this entity is not attached to an AMPL object");
+  }
+  _name = "rAMPL_tmp_" + std::to_string(++counter);
+  _ampl->eval(kind + " " + _name + " " + declaration + ";");
+}
+
+static void warnMessage(void *message) {
+  Rf_warning("%s", static_cast<const std::string *>(message)->c_str());
+}
+
+TempEntity::~TempEntity() {
+  std::string message;
+  try {
+    _ampl->eval("delete " + _name + ";");
+    return;
+  } catch(std::exception &e) {
+    message = "could not delete the temporary entity " + _name + ": " + e.what();
+  } catch(...) {
+    message = "could not delete the temporary entity " + _name;
+  }
+  // The warning must not unwind this destructor if warnings are errors
+  R_ToplevelExec(warnMessage, &message);
+}
+
+const std::string &TempEntity::name() const {
+  return _name;
+}
+
+void updateMembers(ampl::AMPL *ampl, const std::string &name, Rcpp::List columns, const std::string &op) {
+  dataChanged(ampl, name);
+  TempEntity delta(ampl, "set", "dimen " + std::to_string(columns.size()));
+  ampl::Set set = ampl->getSet(delta.name());
+  setMemberColumns(set, columns, 0);
+  ampl->eval("let " + name + " := " + name + " " + op + " " + delta.name() + ";");
+}
+
+TempIndex::TempIndex(ampl::AMPL *ampl, Rcpp::List columns):
+  _ampl(ampl), _columns(columns), _set(ampl, "set", "dimen " + std::to_string(columns.size())) {
+  ampl::Set set = _ampl->getSet(_set.name());
+  setMemberColumns(set, _columns, 0);
+}
+
+std::string TempIndex::indexing() const {
+  std::string dummies;
+  for(int i = 0; i < _columns.size(); i++) {
+    dummies += (i > 0 ? ", " : "") + std::string("rAMPL_i") + std::to_string(i);
+  }
+  if(_columns.size() > 1) {
+    dummies = "(" + dummies + ")";
+  }
+  return "{" + dummies + " in " + _set.name() + "}";
+}
+
+std::string TempIndex::subscript() const {
+  std::string dummies;
+  for(int i = 0; i < _columns.size(); i++) {
+    dummies += (i > 0 ? ", " : "") + std::string("rAMPL_i") + std::to_string(i);
+  }
+  return "[" + dummies + "]";
+}
+
+std::string TempIndex::addParam(SEXP values) {
+  int ncols = _columns.size();
+  std::size_t nrows = XLENGTH(_columns[0]);
+  if(static_cast<std::size_t>(XLENGTH(values)) != nrows) {
+    Rcpp::stop("expected %d values", static_cast<int>(nrows));
+  }
+  _params.push_back(std::unique_ptr<TempEntity>(new TempEntity(_ampl, "param", "{" + _set.name() + "}")));
+  const std::string &name = _params.back()->name();
+  std::vector<std::string> headers(ncols + 1);
+  std::vector<const char *> names(ncols + 1);
+  for(int i = 0; i < ncols; i++) {
+    headers[i] = "index" + std::to_string(i);
+  }
+  headers[ncols] = name;
+  Rcpp::List columns(ncols + 1);
+  for(int i = 0; i <= ncols; i++) {
+    names[i] = headers[i].c_str();
+    columns[i] = i < ncols ? SEXP(_columns[i]) : values;
+  }
+  ampl::DataFrame df(ncols, ampl::StringArgs(names.data(), names.size()));
+  setColumns(df, columns, names.data(), nrows);
+  _ampl->getParameter(name).setValues(df);
+  return name;
+}
+
+bool emptyIndex(Rcpp::List index) {
+  return index.size() == 0 || XLENGTH(index[0]) == 0;
+}
+
+Rcpp::List subsetRows(Rcpp::List columns, Rcpp::LogicalVector mask) {
+  Rcpp::List result(columns.size());
+  for(int i = 0; i < columns.size(); i++) {
+    SEXP column = columns[i];
+    if(XLENGTH(column) != mask.size()) {
+      Rcpp::stop("expected a mask with %d elements", static_cast<int>(XLENGTH(column)));
+    }
+    switch(TYPEOF(column)) {
+      case REALSXP:
+        result[i] = Rcpp::NumericVector(column)[mask];
+        break;
+      case STRSXP:
+        result[i] = Rcpp::CharacterVector(column)[mask];
+        break;
+      default:
+        Rcpp::stop("invalid type");
+    }
+  }
+  return result;
+}
+
+MemberIndex::MemberIndex(): _arity(0), _version(0), _built(false) { }
+
+bool MemberIndex::isCurrent() const {
+  return _built && _version == dataVersion();
+}
+
+void MemberIndex::build(ampl::SetInstance::MemberRange members) {
+  _keys.clear();
+  _arity = 0;
+  std::string key;
+  for(ampl::SetInstance::MemberRange::iterator it = members.begin(); it != members.end(); it++) {
+    ampl::TupleRef tuple = *it;
+    key.clear();
+    for(std::size_t i = 0; i < tuple.size(); i++) {
+      appendKey(key, tuple[i]);
+    }
+    _arity = tuple.size();
+    _keys.insert(key);
+  }
+  _version = dataVersion();
+  _built = true;
+}
+
+Rcpp::LogicalVector MemberIndex::contains(Rcpp::DataFrame tuples) const {
+  int ncols = tuples.size();
+  if(!_keys.empty() && ncols != _arity) {
+    Rcpp::stop("expected %d columns", _arity);
+  }
+  R_xlen_t nrows = tuples.nrows();
+  Rcpp::LogicalVector result(Rcpp::no_init(nrows));
+  std::string key;
+  for(R_xlen_t i = 0; i < nrows; i++) {
+    key.clear();
+    bool complete = true;
+    for(int j = 0; j < ncols && complete; j++) {
+      complete = appendKey(key, tuples[j], i);
+    }
+    result[i] = complete && _keys.find(key) != _keys.end();
   }
-  return Rcpp::DataFrame(tmp);
+  return result;
 }
 
 SEXP variant2sexp(const ampl::VariantRef &value) {
@@ -1,6 +1,14 @@
 #ifndef GUARD_utils_h
 #define GUARD_utils_h
 #include <string>
+#include <cstring>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <functional>
+#include "ampl/ampl.h"
+#include "ampl/entity.h"
 #include "ampl/tuple.h"
 #include "ampl/dataframe.h"
 #include <Rcpp.h>
@@ -20,9 +28,266 @@ Rcpp::XPtr<T> getObj(const std::string &type, SEXP s) {
 ampl::Tuple list2tuple(Rcpp::List list);
 Rcpp::List tuple2list(const ampl::TupleRef &tuple);
 
+const double *dblColumn(SEXP column, std::vector<double> &buffer);
+const char **strColumn(SEXP column, std::vector<const char *> &buffer);
+
+/*
+  Splits an integer (or integral numeric) vector into runs of consecutive
+  values. The vector is read by regions, so ALTREP sequences like 1:n are
+  never expanded. Returns false if there are missing or non-integral
+  values or more than ``maxRuns`` runs.
+*/
+bool integerRuns(SEXP column, std::vector<std::pair<int, int> > &runs, std::size_t maxRuns);
+bool setMemberRanges(ampl::AMPL *ampl, const std::string &name, SEXP column);
+
 ampl::DataFrame rdf2df(Rcpp::DataFrame rdf, int numberOfIndexColumns = -1);
+void setColumns(ampl::DataFrame &df, Rcpp::List columns, const char *const *names, std::size_t nrows);
+
+/*
+  Assigns the members of a set from a list of columns, one per component
+  of the tuples, without building tuples. A single column is passed
+  straight to the set; otherwise the columns are sent in a DataFrame,
+  after ``leading`` placeholder index columns if the set expects them.
+*/
+template <class S>
+void setMemberColumns(S &set, Rcpp::List columns, int leading) {
+  int ncols = columns.size();
+  if(ncols == 0) {
+    Rcpp::stop("expected at least one column");
+  }
+  std::size_t nrows = XLENGTH(columns[0]);
+  for(int i = 1; i < ncols; i++) {
+    if(static_cast<std::size_t>(XLENGTH(columns[i])) != nrows) {
+      Rcpp::stop("all columns must have the same length");
+    }
+  }
+  if(ncols == 1) {
+    SEXP column = columns[0];
+    if(TYPEOF(column) == STRSXP || ::Rf_isFactor(column)) {
+      std::vector<const char *> buffer;
+      set.setValues(strColumn(column, buffer), nrows);
+    } else if(TYPEOF(column) == REALSXP || TYPEOF(column) == INTSXP) {
+      std::vector<double> buffer;
+      set.setValues(dblColumn(column, buffer), nrows);
+    } else {
+      Rcpp::stop("invalid type");
+    }
+    return;
+  }
+  std::vector<std::string> headers(leading + ncols);
+  std::vector<const char *> names(leading + ncols);
+  for(int i = 0; i < leading + ncols; i++) {
+    headers[i] = "index" + std::to_string(i);
+    names[i] = headers[i].c_str();
+  }
+  // With placeholders the members go in the data columns, otherwise every
+  // column is an index
+  ampl::DataFrame df(leading > 0 ? leading : ncols, ampl::StringArgs(names.data(), names.size()));
+  std::vector<double> placeholder(nrows);
+  for(std::size_t row = 0; row < nrows; row++) {
+    placeholder[row] = row + 1;
+  }
+  for(int i = 0; i < leading; i++) {
+    df.setColumn(names[i], placeholder.data(), nrows);
+  }
+  setColumns(df, columns, names.data() + leading, nrows);
+  set.setValues(df);
+}
+
+/*
+  Builds an R column from AMPL values in a single pass. The column is
+  allocated once as numeric and only switches to character when a
+  non-numeric value shows up. With ``integers`` an all-integral numeric
+  column is returned as integer, and with ``factors`` strings are encoded
+  as a factor through a dictionary instead of a character vector.
+*/
+class ColumnBuilder {
+public:
+  ColumnBuilder(R_xlen_t size, bool integers = false, bool factors = false);
+  void set(R_xlen_t i, const ampl::VariantRef &value);
+  void setNA(R_xlen_t i);
+  SEXP get();
+private:
+  R_xlen_t _size;
+  bool _integers;
+  bool _factors;
+  bool _numeric;
+  bool _integral;
+  Rcpp::NumericVector _dbl;
+  Rcpp::CharacterVector _str;
+  Rcpp::IntegerVector _codes;
+  std::unordered_map<std::string, int> _levels;
+  void promote(R_xlen_t filled);
+  void setLabel(R_xlen_t i, const char *label);
+};
+
+std::string dbl2str(double value);
+
+Rcpp::DataFrame makeDataFrame(Rcpp::List columns, Rcpp::CharacterVector names, R_xlen_t nrows);
+Rcpp::DataFrame df2rdf(const ampl::DataFrame &df, bool compact = false);
+Rcpp::DataFrame df2rdf(const ampl::DataFrame &df, bool compact, std::size_t offset, std::size_t nrows);
+Rcpp::DataFrame df2indexframe(const ampl::DataFrame &df);
+SEXP df2valuevector(const ampl::DataFrame &df);
+
+/*
+  Append a type-tagged encoding of an index value to a hash key. Numbers
+  are encoded as doubles whether they come from AMPL, a numeric or an
+  integer column, so the keys of the same tuple always compare equal.
+  Returns false, leaving the key incomplete, for an NA element of an R
+  column, which matches no index.
+*/
+void appendKey(std::string &key, double value);
+void appendKey(std::string &key, const char *value);
+void appendKey(std::string &key, const ampl::VariantRef &value);
+bool appendKey(std::string &key, SEXP column, R_xlen_t i);
+
+/*
+  Assigns consecutive positions to the distinct values of an index column,
+  in order of first appearance, and keeps their labels (e.g. for dimnames)
+  and their types, so that labels can be turned back into AMPL values.
+*/
+class IndexLabels {
+public:
+  int position(const ampl::VariantRef &value);
+  // Position of the value with the specified label, or -1
+  int find(const char *label) const;
+  int size() const;
+  Rcpp::CharacterVector labels() const;
+  const std::string &label(int position) const;
+  bool isNumeric(int position) const;
+  double number(int position) const;
+private:
+  std::unordered_map<std::string, int> _positions;
+  std::unordered_map<std::string, int> _byLabel;
+  std::vector<std::string> _labels;
+  std::vector<double> _numbers;
+  std::vector<bool> _numeric;
+};
 
-Rcpp::DataFrame df2rdf(const ampl::DataFrame &df);
+SEXP df2array(const ampl::DataFrame &df, std::vector<IndexLabels> labels = std::vector<IndexLabels>());
+ampl::DataFrame array2df(SEXP array, const std::string &valueHeader, const std::vector<IndexLabels> &members);
+Rcpp::List members2columns(ampl::SetInstance::MemberRange members, std::size_t size, int arity = -1);
+Rcpp::List members2list(ampl::SetInstance::MemberRange members, std::size_t size);
+SEXP lookupValues(const ampl::DataFrame &df, Rcpp::DataFrame index);
+Rcpp::List df2sparse(const ampl::DataFrame &df, double eps, std::vector<IndexLabels> labels = std::vector<IndexLabels>());
+std::vector<IndexLabels> indexingLabels(ampl::AMPL *ampl, const ampl::Entity &entity);
+std::vector<IndexLabels> memberLabels(ampl::AMPL *ampl, const ampl::Entity &entity);
+ampl::DataFrame sparse2df(SEXP matrix, const std::string &valueHeader, const std::vector<IndexLabels> &members);
+
+/*
+  Wraps an entity instance for R. Wrappers that send statements to AMPL
+  specialize it to keep the AMPL handle.
+*/
+template <class TW, class T>
+TW wrapInstance(const T &instance, ampl::AMPL *) {
+  return TW(instance);
+}
+
+/*
+  Declares a temporary AMPL entity with a unique name, e.g. to hold the
+  data of a bulk statement, and deletes it when going out of scope.
+*/
+class TempEntity {
+public:
+  TempEntity(ampl::AMPL *ampl, const std::string &kind, const std::string &declaration = "");
+  TempEntity(const TempEntity &) = delete;
+  TempEntity &operator=(const TempEntity &) = delete;
+  ~TempEntity();
+  const std::string &name() const;
+private:
+  ampl::AMPL *_ampl;
+  std::string _name;
+};
+
+/*
+  Replaces the members of a set with their union or diff (op) with the
+  tuples in columns, loaded into a temporary set, in a single statement.
+*/
+void updateMembers(ampl::AMPL *ampl, const std::string &name, Rcpp::List columns, const std::string &op);
+
+/*
+  Loads index tuples, given as one column per component, into a temporary
+  set so that a single statement can act on all of them, e.g.::
+
+    TempIndex index(ampl, columns);
+    ampl->eval("drop " + index.indexing() + " c" + index.subscript() + ";");
+
+  Values per tuple go in temporary parameters indexed over the same set.
+  Everything is deleted when the object goes out of scope.
+*/
+class TempIndex {
+public:
+  TempIndex(ampl::AMPL *ampl, Rcpp::List columns);
+  std::string indexing() const;
+  std::string subscript() const;
+  std::string addParam(SEXP values);
+private:
+  ampl::AMPL *_ampl;
+  Rcpp::List _columns;
+  TempEntity _set;
+  std::vector<std::unique_ptr<TempEntity> > _params;
+};
+
+// Whether an index given as a list of columns has no column or no row
+bool emptyIndex(Rcpp::List index);
+Rcpp::List subsetRows(Rcpp::List columns, Rcpp::LogicalVector mask);
+
+/*
+  Version of the data in AMPL, a single counter shared by all AMPL objects,
+  increased by every call of the package that may change it. Caches built
+  from AMPL data are valid while the version they were built at is still
+  the current one. Calls that only change the data of one AMPL object, or
+  of one entity, say so, so that the cached results of everything else are
+  kept.
+*/
+unsigned long dataVersion();
+void dataChanged(ampl::AMPL *ampl = NULL, const std::string &entity = "");
+
+/*
+  Hash index of the members of a set, used to test the membership of many
+  tuples in a single pass. It is built on first use and rebuilt only when
+  the data version has changed.
+*/
+class MemberIndex {
+public:
+  MemberIndex();
+  bool isCurrent() const;
+  void build(ampl::SetInstance::MemberRange members);
+  Rcpp::LogicalVector contains(Rcpp::DataFrame tuples) const;
+private:
+  std::unordered_set<std::string> _keys;
+  int _arity;
+  unsigned long _version;
+  bool _built;
+};
+
+/*
+  Environment in which each of the specified names is bound to a promise
+  calling load(i), with i its 1-based position, the first time it is
+  accessed.
+*/
+Rcpp::Environment lazyEnvironment(Rcpp::CharacterVector names, Rcpp::InternalFunction load);
+
+/*
+  Lazy environment of the size AMPL objects in [begin, end), bound to their
+  names: get(it) returns the object at it and wrap(object) creates its R
+  wrapper on first access.
+*/
+template <class T, class Iterator, class Get, class Wrap>
+Rcpp::Environment lazyObjects(Iterator begin, Iterator end, std::size_t size, Get get, Wrap wrap) {
+  std::shared_ptr<std::vector<T> > objects = std::make_shared<std::vector<T> >();
+  objects->reserve(size);
+  Rcpp::CharacterVector names(size);
+  R_xlen_t i = 0;
+  for(Iterator it = begin; it != end; it++, i++) {
+    objects->push_back(get(it));
+    names[i] = objects->back().name();
+  }
+  std::function<SEXP(int)> load = [objects, wrap](int i) -> SEXP {
+    return Rcpp::wrap(wrap((*objects)[i - 1]));
+  };
+  return lazyEnvironment(names, Rcpp::InternalFunction(load));
+}
 
 SEXP variant2sexp(const ampl::VariantRef &value);
 SEXP variant2sexp(const ampl::Variant &value);